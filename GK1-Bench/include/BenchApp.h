@@ -0,0 +1,45 @@
+#pragma once
+#include "MyApp.h"
+#include "BenchStats.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class BenchApp : public MyApp
+{
+public:
+	struct Settings
+	{
+		int frames = 600;
+		int warmupFrames = 60;
+		float deltaTime = 1.0f / 60.0f;
+		int width = 1600;
+		int height = 900;
+		HeadlessMode context = HeadlessMode::EGL;
+	};
+
+	explicit BenchApp(const Settings &settings);
+	~BenchApp();
+
+	void RunBenchmark();
+	std::string ToJson() const;
+
+private:
+	void CreateRenderTarget();
+	void DestroyRenderTarget();
+	void RecordGpuPasses();
+	bool IsNullGL() const { return m_settings.context == HeadlessMode::Null; }
+
+	Settings m_settings;
+	GLuint m_fbo = 0;
+	GLuint m_colorBuffer = 0;
+	GLuint m_depthBuffer = 0;
+
+	double m_loadTime = 0.0;
+	double m_startTime = 0.0;
+	std::vector<BenchPhase> m_phases;
+	std::vector<BenchPhase> m_gpuPasses;
+	uint64_t m_gpuFrame = 0;
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchPhase
+{
+	std::string name;
+	std::vector<double> samples; // milliseconds
+};
+
+// Writes "name": { mean/min/p50/p95/max } for a phase
+void WritePhase(std::ostringstream &out, const BenchPhase &phase);
+double Percentile(std::vector<double> samples, double p);
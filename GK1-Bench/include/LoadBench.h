@@ -0,0 +1,42 @@
+#pragma once
+#include "BenchStats.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Asset loading throughput without a window or GL context
+class LoadBench
+{
+public:
+	struct Settings
+	{
+		std::vector<std::string> files;
+		// Generated OBJs with this many small groups sharing one position array
+		std::vector<int> groupCounts;
+		int repeat = 20;
+	};
+
+	explicit LoadBench(const Settings &settings) : m_settings(settings) {}
+
+	// Returns false if a file could not be read
+	bool Run();
+	std::string ToJson() const;
+
+private:
+	struct FileResult
+	{
+		std::string path;
+		int groups = 0;
+		size_t bytes = 0;
+		size_t corners = 0;
+		BenchPhase parse;
+		BenchPhase process;
+	};
+
+	static std::string MakeGroupedOBJ(int groupCount);
+	void Measure(std::string_view source, FileResult &result);
+
+	Settings m_settings;
+	std::vector<FileResult> m_results;
+};
@@ -0,0 +1,256 @@
+#include "BenchApp.h"
+
+#include <Engine/GpuProfiler.h>
+#include <Engine/Input.h>
+#include <Engine/Log.h>
+#include <Engine/NullGL.h>
+#include <Engine/Profiler.h>
+#include <Engine/RenderStats.h>
+#include <Engine/ResourceManager.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMs(Clock::time_point start, Clock::time_point end)
+{
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+enum PhaseIndex
+{
+	kPhaseInput,
+	kPhaseUpdate,
+	kPhaseDraw,
+	kPhaseGpu,
+	kPhaseFrame,
+	kPhaseCount
+};
+
+BenchApp::BenchApp(const Settings &settings)
+	: MyApp("GK1-Bench", settings.width, settings.height, settings.context)
+	, m_settings(settings)
+{
+	m_phases = {
+		{ "input", {} },
+		{ "update", {} },
+		{ "draw", {} },
+		{ "gpu_wait", {} },
+		{ "frame", {} },
+	};
+}
+
+BenchApp::~BenchApp()
+{
+	DestroyRenderTarget();
+}
+
+void BenchApp::RunBenchmark()
+{
+	auto start = Clock::now();
+	{
+		PROFILE_SCOPE("App::OnLoad");
+		OnLoad(&ResourceManager::Get());
+	}
+	auto loaded = Clock::now();
+	{
+		PROFILE_SCOPE("App::OnStart");
+		OnStart();
+		// Frames are measured on the complete scene
+		ResourceManager::Get().WaitForLoads();
+	}
+	auto started = Clock::now();
+	Profiler::EndStartup();
+
+	m_loadTime = ElapsedMs(start, loaded);
+	m_startTime = ElapsedMs(loaded, started);
+
+	// The default framebuffer of a surfaceless context may be incomplete, so render into our own
+	CreateRenderTarget();
+	OnResize(m_settings.width, m_settings.height);
+
+	for (auto &phase : m_phases)
+		phase.samples.reserve(m_settings.frames);
+
+	Log::Info("Benchmarking " + std::to_string(m_settings.frames) + " frames");
+
+	for (int frame = 0; frame < m_settings.warmupFrames + m_settings.frames; frame++)
+	{
+		PROFILE_SCOPE("App::Frame");
+		auto frameStart = Clock::now();
+
+		Input::Update();
+		auto inputDone = Clock::now();
+
+		{
+			PROFILE_SCOPE("App::OnUpdate");
+			OnUpdate(m_settings.deltaTime);
+		}
+		auto updateDone = Clock::now();
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+		glViewport(0, 0, m_settings.width, m_settings.height);
+		GpuProfiler::BeginFrame();
+		if (frame >= m_settings.warmupFrames)
+			RecordGpuPasses();
+		{
+			PROFILE_SCOPE("App::OnRender");
+			OnRender(GetRenderer());
+		}
+		GpuProfiler::EndFrame();
+		RenderStats::EndFrame();
+		auto drawDone = Clock::now();
+
+		// Wait for the GPU so the frame cost is not deferred to a later frame
+		{
+			PROFILE_SCOPE("glFinish");
+			glFinish();
+		}
+		auto frameEnd = Clock::now();
+
+		if (IsNullGL())
+		{
+			NullGL::EndFrame();
+			if (frame + 1 == m_settings.warmupFrames)
+				NullGL::ResetTotals();
+		}
+
+		if (frame < m_settings.warmupFrames)
+			continue;
+
+		m_phases[kPhaseInput].samples.push_back(ElapsedMs(frameStart, inputDone));
+		m_phases[kPhaseUpdate].samples.push_back(ElapsedMs(inputDone, updateDone));
+		m_phases[kPhaseDraw].samples.push_back(ElapsedMs(updateDone, drawDone));
+		m_phases[kPhaseGpu].samples.push_back(ElapsedMs(drawDone, frameEnd));
+		m_phases[kPhaseFrame].samples.push_back(ElapsedMs(frameStart, frameEnd));
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+std::string BenchApp::ToJson() const
+{
+	auto glString = [](GLenum name)
+		{
+			const GLubyte *str = glGetString(name);
+			return str ? std::string(reinterpret_cast<const char *>(str)) : std::string();
+		};
+
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(4);
+	out << "{\n";
+	out << "  \"scene\": \"racer\",\n";
+	out << "  \"gl_renderer\": \"" << glString(GL_RENDERER) << "\",\n";
+	out << "  \"gl_version\": \"" << glString(GL_VERSION) << "\",\n";
+	out << "  \"resolution\": [" << m_settings.width << ", " << m_settings.height << "],\n";
+	out << "  \"frames\": " << m_settings.frames << ",\n";
+	out << "  \"warmup_frames\": " << m_settings.warmupFrames << ",\n";
+	out << "  \"startup_ms\": { \"load\": " << m_loadTime << ", \"start\": " << m_startTime << " },\n";
+	out << "  \"phases\": {\n";
+	for (size_t i = 0; i < m_phases.size(); i++)
+	{
+		WritePhase(out, m_phases[i]);
+		out << (i + 1 < m_phases.size() ? ",\n" : "\n");
+	}
+	out << "  },\n";
+	const auto &stats = RenderStats::Last();
+	out << "  \"render_stats\": { \"draw_calls\": " << stats.drawCalls
+		<< ", \"triangles\": " << stats.triangles
+		<< ", \"patches\": " << stats.patches
+		<< ", \"program_changes\": " << stats.programChanges
+		<< ", \"texture_binds\": " << stats.textureBinds
+		<< ", \"uniform_uploads\": " << stats.uniformUploads
+		<< ", \"buffer_bytes\": " << stats.bufferBytes
+		<< ", \"texture_bytes\": " << stats.textureBytes << " },\n";
+	const auto &textureCache = ResourceManager::Get().GetTextureCache().GetStats();
+	out << "  \"texture_cache\": { \"hits\": " << textureCache.hits
+		<< ", \"misses\": " << textureCache.misses
+		<< ", \"bytes_saved\": " << textureCache.bytesSaved << " },\n";
+	out << "  \"gpu_passes\": {\n";
+	for (size_t i = 0; i < m_gpuPasses.size(); i++)
+	{
+		WritePhase(out, m_gpuPasses[i]);
+		out << (i + 1 < m_gpuPasses.size() ? ",\n" : "\n");
+	}
+	out << "  }";
+
+	if (IsNullGL())
+	{
+		// Average calls per measured frame, redundant state changes show up as outliers here
+		auto calls = NullGL::GetAverageHistogram();
+		double total = 0.0;
+		for (const auto &call : calls)
+			total += call.count;
+
+		out << ",\n  \"gl_calls_per_frame\": " << total << ",\n";
+		out << "  \"gl_call_histogram\": {\n";
+		for (size_t i = 0; i < calls.size(); i++)
+		{
+			out << "    \"" << calls[i].name << "\": " << calls[i].count;
+			out << (i + 1 < calls.size() ? ",\n" : "\n");
+		}
+		out << "  }";
+	}
+	out << "\n";
+	out << "}\n";
+	return out.str();
+}
+
+void BenchApp::RecordGpuPasses()
+{
+	// Timer results lag GpuProfiler::kFrameLatency frames behind, one sample per resolved frame
+	if (GpuProfiler::GetResolvedFrames() == m_gpuFrame)
+		return;
+	m_gpuFrame = GpuProfiler::GetResolvedFrames();
+
+	for (const auto &result : GpuProfiler::GetResults())
+	{
+		auto it = std::find_if(m_gpuPasses.begin(), m_gpuPasses.end(),
+			[&result](const BenchPhase &phase)
+			{
+				return phase.name == result.name;
+			});
+		if (it == m_gpuPasses.end())
+		{
+			m_gpuPasses.push_back({ result.name, {} });
+			it = m_gpuPasses.end() - 1;
+		}
+		it->samples.push_back(result.milliseconds);
+	}
+}
+
+void BenchApp::CreateRenderTarget()
+{
+	glGenFramebuffers(1, &m_fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+	glGenRenderbuffers(1, &m_colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_settings.width, m_settings.height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_settings.width, m_settings.height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		throw std::runtime_error("Failed to create benchmark framebuffer");
+
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void BenchApp::DestroyRenderTarget()
+{
+	if (m_fbo != 0)
+	{
+		glDeleteFramebuffers(1, &m_fbo);
+		glDeleteRenderbuffers(1, &m_colorBuffer);
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+		m_fbo = 0;
+	}
+}
@@ -0,0 +1,25 @@
+#include "BenchStats.h"
+
+#include <algorithm>
+
+double Percentile(std::vector<double> samples, double p)
+{
+	if (samples.empty()) return 0.0;
+	std::sort(samples.begin(), samples.end());
+	size_t index = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+	return samples[index];
+}
+
+void WritePhase(std::ostringstream &out, const BenchPhase &phase)
+{
+	double mean = 0.0;
+	for (double sample : phase.samples)
+		mean += sample;
+
+	out << "    \"" << phase.name << "\": { ";
+	out << "\"mean_ms\": " << (phase.samples.empty() ? 0.0 : mean / phase.samples.size()) << ", ";
+	out << "\"min_ms\": " << Percentile(phase.samples, 0.0) << ", ";
+	out << "\"p50_ms\": " << Percentile(phase.samples, 0.5) << ", ";
+	out << "\"p95_ms\": " << Percentile(phase.samples, 0.95) << ", ";
+	out << "\"max_ms\": " << Percentile(phase.samples, 1.0) << " }";
+}
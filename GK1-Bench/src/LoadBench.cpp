@@ -0,0 +1,157 @@
+#include "LoadBench.h"
+
+#include <Engine/Loader/Model/OBJLoader.h>
+#include <Engine/MappedFile.h>
+#include <Engine/Profiler.h>
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+	// Every generated group is a kPatchSize x kPatchSize quad grid
+	constexpr int kPatchSize = 4;
+
+	double MillisecondsSince(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+}
+
+bool LoadBench::Run()
+{
+	for (const auto &path : m_settings.files)
+	{
+		// Mapped once, page faults of the first read are not part of the measurement
+		MappedFile file;
+		if (!file.Open(path))
+		{
+			std::cerr << "Failed to open " << path << std::endl;
+			return false;
+		}
+
+		FileResult result;
+		result.path = path;
+		Measure(file.GetView(), result);
+		m_results.push_back(std::move(result));
+	}
+
+	for (int groupCount : m_settings.groupCounts)
+	{
+		std::string source = MakeGroupedOBJ(groupCount);
+
+		FileResult result;
+		result.path = "generated";
+		Measure(source, result);
+		m_results.push_back(std::move(result));
+	}
+	return true;
+}
+
+void LoadBench::Measure(std::string_view source, FileResult &result)
+{
+	result.bytes = source.size();
+	result.parse.name = "parse";
+	result.process.name = "process";
+
+	for (int i = 0; i < m_settings.repeat; i++)
+	{
+		OBJLoader::ParsedOBJ parsed;
+		{
+			PROFILE_SCOPE("LoadBench::Parse");
+			auto start = Clock::now();
+			OBJLoader::ParseOBJ(source, parsed);
+			result.parse.samples.push_back(MillisecondsSince(start));
+		}
+
+		PROFILE_SCOPE("LoadBench::Process");
+		auto start = Clock::now();
+		result.groups = 0;
+		result.corners = 0;
+		for (const auto &group : parsed.groups)
+		{
+			if (group.vertexIndices.empty()) continue;
+			OBJLoader::ProcessMeshData(parsed, group);
+			result.groups++;
+			result.corners += group.vertexIndices.size();
+		}
+		result.process.samples.push_back(MillisecondsSince(start));
+	}
+}
+
+std::string LoadBench::MakeGroupedOBJ(int groupCount)
+{
+	// All positions come first, like exporters write multi-material models, so every group indexes into the
+	// file-wide array and per-group work proportional to the whole file shows up as quadratic scaling
+	constexpr int kSide = kPatchSize + 1;
+	std::ostringstream out;
+	for (int group = 0; group < groupCount; group++)
+	{
+		for (int y = 0; y < kSide; y++)
+		{
+			for (int x = 0; x < kSide; x++)
+				out << "v " << group * kSide + x << " 0 " << y << "\n";
+		}
+	}
+	for (int y = 0; y < kSide; y++)
+	{
+		for (int x = 0; x < kSide; x++)
+			out << "vt " << x / float(kPatchSize) << " " << y / float(kPatchSize) << "\n";
+	}
+
+	for (int group = 0; group < groupCount; group++)
+	{
+		out << "g patch" << group << "\n";
+		int base = group * kSide * kSide + 1;
+		for (int y = 0; y < kPatchSize; y++)
+		{
+			for (int x = 0; x < kPatchSize; x++)
+			{
+				int corner = y * kSide + x;
+				int corners[4] = { corner, corner + 1, corner + kSide + 1, corner + kSide };
+				out << "f";
+				for (int c : corners)
+					out << " " << base + c << "/" << c + 1;
+				out << "\n";
+			}
+		}
+	}
+	return out.str();
+}
+
+std::string LoadBench::ToJson() const
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(4);
+	out << "{\n";
+	out << "  \"repeat\": " << m_settings.repeat << ",\n";
+	out << "  \"files\": [\n";
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		const FileResult &result = m_results[i];
+		double medianMs = Percentile(result.parse.samples, 0.5);
+		double megabytesPerSecond = medianMs > 0.0 ? (result.bytes / 1e6) / (medianMs / 1000.0) : 0.0;
+		// Flat across group counts when mesh processing scales linearly with the file
+		double processNsPerCorner = result.corners > 0 ? Percentile(result.process.samples, 0.5) * 1e6 / result.corners : 0.0;
+
+		out << "  {\n";
+		out << "    \"path\": \"" << std::filesystem::path(result.path).generic_string() << "\",\n";
+		out << "    \"bytes\": " << result.bytes << ",\n";
+		out << "    \"groups\": " << result.groups << ",\n";
+		out << "    \"corners\": " << result.corners << ",\n";
+		out << "    \"mb_per_s\": " << megabytesPerSecond << ",\n";
+		out << "    \"process_ns_per_corner\": " << processNsPerCorner << ",\n";
+		WritePhase(out, result.parse);
+		out << ",\n";
+		WritePhase(out, result.process);
+		out << "\n  }" << (i + 1 < m_results.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n";
+	out << "}\n";
+	return out.str();
+}
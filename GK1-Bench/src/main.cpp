@@ -0,0 +1,123 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "BenchApp.h"
+#include "LoadBench.h"
+#include <Engine/Profiler.h>
+
+static void PrintUsage()
+{
+	std::cerr << "Usage: GK1-Bench [options]\n"
+		<< "  --frames <n>             Measured frames (default 600)\n"
+		<< "  --warmup <n>             Frames run before measuring (default 60)\n"
+		<< "  --size <width>x<height>  Render target size (default 1600x900)\n"
+		<< "  --context <egl|osmesa|null>\n"
+		<< "                           Offscreen context API (default egl), null records GL calls without a GPU\n"
+		<< "  --load <file.obj>        Measure OBJ parsing throughput instead of frames (repeatable)\n"
+		<< "  --load-groups <n>        Same for a generated OBJ with n small groups (repeatable)\n"
+		<< "  --repeat <n>             Parses per file in --load mode (default 20)\n"
+		<< "  --out <file>             Write the JSON report to a file instead of stdout\n"
+		<< "  --trace <file>           Write a chrome://tracing profile of the run\n";
+}
+
+int main(int argc, char **argv)
+{
+	BenchApp::Settings settings;
+	LoadBench::Settings loadSettings;
+	std::string outputPath;
+	std::string tracePath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--frames" && hasValue)
+			settings.frames = std::stoi(argv[++i]);
+		else if (arg == "--warmup" && hasValue)
+			settings.warmupFrames = std::stoi(argv[++i]);
+		else if (arg == "--size" && hasValue)
+		{
+			std::string size = argv[++i];
+			size_t x = size.find('x');
+			if (x == std::string::npos)
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+			settings.width = std::stoi(size.substr(0, x));
+			settings.height = std::stoi(size.substr(x + 1));
+		}
+		else if (arg == "--context" && hasValue)
+		{
+			std::string context = argv[++i];
+			if (context == "egl")
+				settings.context = App::HeadlessMode::EGL;
+			else if (context == "osmesa")
+				settings.context = App::HeadlessMode::OSMesa;
+			else if (context == "null")
+				settings.context = App::HeadlessMode::Null;
+			else
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+		else if (arg == "--load" && hasValue)
+			loadSettings.files.push_back(argv[++i]);
+		else if (arg == "--load-groups" && hasValue)
+			loadSettings.groupCounts.push_back(std::stoi(argv[++i]));
+		else if (arg == "--repeat" && hasValue)
+			loadSettings.repeat = std::stoi(argv[++i]);
+		else if (arg == "--out" && hasValue)
+			outputPath = argv[++i];
+		else if (arg == "--trace" && hasValue)
+			tracePath = argv[++i];
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	try
+	{
+		std::string report;
+		if (!loadSettings.files.empty() || !loadSettings.groupCounts.empty())
+		{
+			Profiler::SetThreadName("Main");
+			Profiler::EndStartup();
+
+			LoadBench bench(loadSettings);
+			if (!bench.Run())
+				return EXIT_FAILURE;
+			report = bench.ToJson();
+		}
+		else
+		{
+			BenchApp app(settings);
+			app.RunBenchmark();
+			report = app.ToJson();
+		}
+
+		if (!tracePath.empty() && !Profiler::WriteChromeTrace(tracePath))
+			std::cerr << "Failed to write trace: " << tracePath << std::endl;
+
+		if (outputPath.empty())
+		{
+			std::cout << report;
+		}
+		else
+		{
+			std::ofstream file(outputPath);
+			file << report;
+		}
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU encoder for the block formats the engine uploads. Endpoints come from the principal axis of each block and one
+// least-squares refinement, which is fine for diffuse and normal maps but slower and a bit worse than GPU encoders.
+class BlockEncoder
+{
+public:
+	enum class Format
+	{
+		BC1,
+		BC3,
+		BC5
+	};
+
+	static size_t GetBlockSize(Format format) { return format == Format::BC1 ? 8 : 16; }
+
+	// Encodes one level of tightly packed RGBA8 pixels, block rows are spread over the job system
+	static std::vector<uint8_t> Encode(Format format, const uint8_t *rgba, int width, int height);
+	// Decodes the blocks back to RGBA8 the way GPUs interpolate them, used to report the encoding error
+	static std::vector<uint8_t> Decode(Format format, const uint8_t *blocks, int width, int height);
+
+	// Single 4x4 blocks, pixels are 16 RGBA8 values in row order
+	static void EncodeBC1(const uint8_t *pixels, uint8_t *block);
+	static void EncodeBC3(const uint8_t *pixels, uint8_t *block);
+	static void EncodeBC5(const uint8_t *pixels, uint8_t *block);
+
+private:
+	BlockEncoder() = default;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Bundles every file below a directory into a .gk1pak that the engine mounts with FileSystem::Mount. Entries are
+// named by the path the game loads them from, the directory as given plus the relative path, so run it from the
+// game's working directory. An entry is stored LZ4-compressed only if that saves enough to pay for decompressing.
+class PackWriter
+{
+public:
+	struct Result
+	{
+		size_t entryCount = 0;
+		size_t compressedCount = 0;
+		size_t sourceBytes = 0;
+		size_t packBytes = 0;
+		double milliseconds = 0.0;
+	};
+
+	static bool Write(const std::string &directory, const std::string &outputPath, bool compress, Result &result);
+
+private:
+	PackWriter() = default;
+
+	// Compressed entries must be at most this fraction of their size, already compressed images rarely are
+	static constexpr double kMaxCompressedRatio = 0.875;
+};
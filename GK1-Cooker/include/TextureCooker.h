@@ -0,0 +1,50 @@
+#pragma once
+#include "BlockEncoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Turns source images into KTX2 files with a full mip chain, written to the path TextureCache prefers over the
+// source. Color maps become BC1, or BC3 if any pixel is translucent, normal maps BC5. Uncompressed cooking keeps the
+// source's 8-bit channels and only saves the load-time mip generation. Skyboxes can be cooked into one cubemap array.
+class TextureCooker
+{
+public:
+	enum class Usage
+	{
+		Color,
+		Normal
+	};
+
+	struct Result
+	{
+		std::string cookedPath;
+		bool compressed = true;
+		BlockEncoder::Format format = BlockEncoder::Format::BC1;
+		int channels = 0;
+		int width = 0;
+		int height = 0;
+		int levels = 0;
+		// What the engine uploads for the source, including the levels it generates
+		size_t sourceBytes = 0;
+		size_t cookedBytes = 0;
+		// Base level over the channels the format stores, 0 when uncompressed
+		double psnr = 0.0;
+		double milliseconds = 0.0;
+	};
+
+	static bool Cook(const std::string &sourcePath, Usage usage, bool compress, Result &result);
+	// Six faces per cube in +X, -X, +Y, -Y, +Z, -Z order, all of one size. Only the base level is stored, the engine
+	// never minifies a skybox.
+	static bool CookCubemapArray(const std::vector<std::string> &facePaths, const std::string &outputPath, bool compress, Result &result);
+
+private:
+	TextureCooker() = default;
+
+	static double ComputePSNR(BlockEncoder::Format format, const uint8_t *original, const std::vector<uint8_t> &decoded);
+	// cubeCount 0 writes a 2D texture stored bottom-up, otherwise a cubemap array stored top-down like GL addresses faces
+	static bool WriteKTX2(const std::string &path, uint32_t vkFormat, int width, int height, int cubeCount,
+		const std::vector<std::vector<uint8_t>> &levels);
+};
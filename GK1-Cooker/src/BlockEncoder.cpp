@@ -0,0 +1,346 @@
+#include "BlockEncoder.h"
+#include <Engine/JobSystem.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <glm/glm.hpp>
+
+namespace
+{
+	constexpr int kBlockDimension = 4;
+	constexpr int kBlockPixels = kBlockDimension * kBlockDimension;
+
+	struct ColorFit
+	{
+		uint16_t color0;
+		uint16_t color1;
+		uint8_t indices[kBlockPixels];
+		float error;
+	};
+
+	// Colors are kept in 0-255 floats while fitting
+	uint16_t PackColor(const glm::vec3 &color)
+	{
+		int r = std::clamp(static_cast<int>(std::lround(color.r * 31.0f / 255.0f)), 0, 31);
+		int g = std::clamp(static_cast<int>(std::lround(color.g * 63.0f / 255.0f)), 0, 63);
+		int b = std::clamp(static_cast<int>(std::lround(color.b * 31.0f / 255.0f)), 0, 31);
+		return static_cast<uint16_t>(r << 11 | g << 5 | b);
+	}
+
+	glm::vec3 UnpackColor(uint16_t color)
+	{
+		int r = (color >> 11) & 31;
+		int g = (color >> 5) & 63;
+		int b = color & 31;
+		return glm::vec3(r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2);
+	}
+
+	// Four color mode, which is the only one the encoder writes
+	void GetPalette(uint16_t color0, uint16_t color1, glm::vec3 palette[4])
+	{
+		palette[0] = UnpackColor(color0);
+		palette[1] = UnpackColor(color1);
+		palette[2] = (2.0f * palette[0] + palette[1]) / 3.0f;
+		palette[3] = (palette[0] + 2.0f * palette[1]) / 3.0f;
+	}
+
+	ColorFit FitEndpoints(const glm::vec3 colors[kBlockPixels], const glm::vec3 &start, const glm::vec3 &end)
+	{
+		ColorFit fit;
+		fit.color0 = PackColor(start);
+		fit.color1 = PackColor(end);
+		fit.error = 0.0f;
+
+		// color0 > color1 selects the four color mode, equal endpoints fall back to the three color mode whose
+		// index 0 is still color0
+		if (fit.color0 < fit.color1) std::swap(fit.color0, fit.color1);
+
+		glm::vec3 palette[4];
+		GetPalette(fit.color0, fit.color1, palette);
+		int paletteSize = fit.color0 == fit.color1 ? 1 : 4;
+		for (int i = 0; i < kBlockPixels; i++)
+		{
+			float bestError = std::numeric_limits<float>::max();
+			for (int k = 0; k < paletteSize; k++)
+			{
+				glm::vec3 difference = colors[i] - palette[k];
+				float error = glm::dot(difference, difference);
+				if (error < bestError)
+				{
+					bestError = error;
+					fit.indices[i] = static_cast<uint8_t>(k);
+				}
+			}
+			fit.error += bestError;
+		}
+		return fit;
+	}
+
+	// Least-squares endpoints for the indices of an earlier fit
+	bool RefineEndpoints(const glm::vec3 colors[kBlockPixels], const uint8_t indices[kBlockPixels], glm::vec3 &start, glm::vec3 &end)
+	{
+		static constexpr float kWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+		float alpha2 = 0.0f, beta2 = 0.0f, alphaBeta = 0.0f;
+		glm::vec3 alphaX(0.0f), betaX(0.0f);
+		for (int i = 0; i < kBlockPixels; i++)
+		{
+			float alpha = kWeights[indices[i]];
+			float beta = 1.0f - alpha;
+			alpha2 += alpha * alpha;
+			beta2 += beta * beta;
+			alphaBeta += alpha * beta;
+			alphaX += alpha * colors[i];
+			betaX += beta * colors[i];
+		}
+
+		float determinant = alpha2 * beta2 - alphaBeta * alphaBeta;
+		if (std::abs(determinant) < 1e-6f) return false;
+
+		start = glm::clamp((alphaX * beta2 - betaX * alphaBeta) / determinant, 0.0f, 255.0f);
+		end = glm::clamp((betaX * alpha2 - alphaX * alphaBeta) / determinant, 0.0f, 255.0f);
+		return true;
+	}
+
+	void EncodeColorBlock(const uint8_t *pixels, uint8_t *block)
+	{
+		glm::vec3 colors[kBlockPixels];
+		glm::vec3 mean(0.0f), minimum(255.0f), maximum(0.0f);
+		for (int i = 0; i < kBlockPixels; i++)
+		{
+			colors[i] = glm::vec3(pixels[i * 4], pixels[i * 4 + 1], pixels[i * 4 + 2]);
+			mean += colors[i];
+			minimum = glm::min(minimum, colors[i]);
+			maximum = glm::max(maximum, colors[i]);
+		}
+		mean /= static_cast<float>(kBlockPixels);
+
+		glm::mat3 covariance(0.0f);
+		for (int i = 0; i < kBlockPixels; i++)
+		{
+			glm::vec3 offset = colors[i] - mean;
+			covariance += glm::outerProduct(offset, offset);
+		}
+
+		// Principal axis by power iteration, starting from the bounding box diagonal
+		glm::vec3 axis = maximum - minimum;
+		for (int i = 0; i < 8 && glm::dot(axis, axis) > 0.0f; i++)
+		{
+			axis = covariance * axis;
+			float length = glm::length(axis);
+			axis = length > 0.0f ? axis / length : glm::vec3(0.0f);
+		}
+
+		float lowest = 0.0f, highest = 0.0f;
+		for (int i = 0; i < kBlockPixels; i++)
+		{
+			float t = glm::dot(colors[i] - mean, axis);
+			lowest = std::min(lowest, t);
+			highest = std::max(highest, t);
+		}
+
+		glm::vec3 start = glm::clamp(mean + highest * axis, 0.0f, 255.0f);
+		glm::vec3 end = glm::clamp(mean + lowest * axis, 0.0f, 255.0f);
+		ColorFit fit = FitEndpoints(colors, start, end);
+
+		if (fit.error > 0.0f && fit.color0 != fit.color1 && RefineEndpoints(colors, fit.indices, start, end))
+		{
+			ColorFit refined = FitEndpoints(colors, start, end);
+			if (refined.error < fit.error) fit = refined;
+		}
+
+		block[0] = static_cast<uint8_t>(fit.color0);
+		block[1] = static_cast<uint8_t>(fit.color0 >> 8);
+		block[2] = static_cast<uint8_t>(fit.color1);
+		block[3] = static_cast<uint8_t>(fit.color1 >> 8);
+		for (int row = 0; row < kBlockDimension; row++)
+		{
+			const uint8_t *indices = fit.indices + row * kBlockDimension;
+			block[4 + row] = static_cast<uint8_t>(indices[0] | indices[1] << 2 | indices[2] << 4 | indices[3] << 6);
+		}
+	}
+
+	// Eight value mode between the block's extremes
+	void EncodeChannelBlock(const uint8_t *pixels, int channel, uint8_t *block)
+	{
+		uint8_t minimum = 255, maximum = 0;
+		for (int i = 0; i < kBlockPixels; i++)
+		{
+			minimum = std::min(minimum, pixels[i * 4 + channel]);
+			maximum = std::max(maximum, pixels[i * 4 + channel]);
+		}
+
+		block[0] = maximum;
+		block[1] = minimum;
+
+		// Equal endpoints select the six value mode whose index 0 is still the endpoint, so all indices stay 0
+		uint64_t bits = 0;
+		if (maximum != minimum)
+		{
+			float palette[8] = { float(maximum), float(minimum) };
+			for (int k = 1; k < 7; k++)
+				palette[k + 1] = ((7 - k) * maximum + k * minimum) / 7.0f;
+
+			for (int i = 0; i < kBlockPixels; i++)
+			{
+				float value = pixels[i * 4 + channel];
+				int best = 0;
+				for (int k = 1; k < 8; k++)
+				{
+					if (std::abs(palette[k] - value) < std::abs(palette[best] - value)) best = k;
+				}
+				bits |= static_cast<uint64_t>(best) << (3 * i);
+			}
+		}
+
+		for (int i = 0; i < 6; i++)
+			block[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+	}
+
+	void DecodeColorBlock(const uint8_t *block, uint8_t *pixels)
+	{
+		uint16_t color0 = static_cast<uint16_t>(block[0] | block[1] << 8);
+		uint16_t color1 = static_cast<uint16_t>(block[2] | block[3] << 8);
+		glm::vec3 palette[4];
+		GetPalette(color0, color1, palette);
+		if (color0 <= color1)
+		{
+			palette[2] = (palette[0] + palette[1]) / 2.0f;
+			palette[3] = glm::vec3(0.0f);
+		}
+
+		for (int i = 0; i < kBlockPixels; i++)
+		{
+			int index = (block[4 + i / kBlockDimension] >> (2 * (i % kBlockDimension))) & 3;
+			for (int c = 0; c < 3; c++)
+				pixels[i * 4 + c] = static_cast<uint8_t>(std::lround(palette[index][c]));
+			pixels[i * 4 + 3] = 255;
+		}
+	}
+
+	void DecodeChannelBlock(const uint8_t *block, int channel, uint8_t *pixels)
+	{
+		float palette[8] = { float(block[0]), float(block[1]) };
+		if (block[0] > block[1])
+		{
+			for (int k = 1; k < 7; k++)
+				palette[k + 1] = ((7 - k) * palette[0] + k * palette[1]) / 7.0f;
+		}
+		else
+		{
+			for (int k = 1; k < 5; k++)
+				palette[k + 1] = ((5 - k) * palette[0] + k * palette[1]) / 5.0f;
+			palette[6] = 0.0f;
+			palette[7] = 255.0f;
+		}
+
+		uint64_t bits = 0;
+		for (int i = 0; i < 6; i++)
+			bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+		for (int i = 0; i < kBlockPixels; i++)
+			pixels[i * 4 + channel] = static_cast<uint8_t>(std::lround(palette[(bits >> (3 * i)) & 7]));
+	}
+}
+
+void BlockEncoder::EncodeBC1(const uint8_t *pixels, uint8_t *block)
+{
+	EncodeColorBlock(pixels, block);
+}
+
+void BlockEncoder::EncodeBC3(const uint8_t *pixels, uint8_t *block)
+{
+	EncodeChannelBlock(pixels, 3, block);
+	EncodeColorBlock(pixels, block + 8);
+}
+
+void BlockEncoder::EncodeBC5(const uint8_t *pixels, uint8_t *block)
+{
+	EncodeChannelBlock(pixels, 0, block);
+	EncodeChannelBlock(pixels, 1, block + 8);
+}
+
+std::vector<uint8_t> BlockEncoder::Encode(Format format, const uint8_t *rgba, int width, int height)
+{
+	size_t blocksX = (width + kBlockDimension - 1) / kBlockDimension;
+	size_t blocksY = (height + kBlockDimension - 1) / kBlockDimension;
+	size_t blockSize = GetBlockSize(format);
+	std::vector<uint8_t> blocks(blocksX * blocksY * blockSize);
+
+	JobSystem::Get().ParallelFor(blocksY, [&](size_t blockY)
+		{
+			uint8_t pixels[kBlockPixels * 4];
+			for (size_t blockX = 0; blockX < blocksX; blockX++)
+			{
+				// Blocks past the edge repeat the last row and column so they do not pull the endpoints
+				for (int y = 0; y < kBlockDimension; y++)
+				{
+					for (int x = 0; x < kBlockDimension; x++)
+					{
+						size_t sourceX = std::min<size_t>(blockX * kBlockDimension + x, width - 1);
+						size_t sourceY = std::min<size_t>(blockY * kBlockDimension + y, height - 1);
+						std::memcpy(pixels + (y * kBlockDimension + x) * 4, rgba + (sourceY * width + sourceX) * 4, 4);
+					}
+				}
+
+				uint8_t *block = blocks.data() + (blockY * blocksX + blockX) * blockSize;
+				switch (format)
+				{
+				case Format::BC1:
+					EncodeBC1(pixels, block);
+					break;
+				case Format::BC3:
+					EncodeBC3(pixels, block);
+					break;
+				case Format::BC5:
+					EncodeBC5(pixels, block);
+					break;
+				}
+			}
+		});
+	return blocks;
+}
+
+std::vector<uint8_t> BlockEncoder::Decode(Format format, const uint8_t *blocks, int width, int height)
+{
+	size_t blocksX = (width + kBlockDimension - 1) / kBlockDimension;
+	size_t blocksY = (height + kBlockDimension - 1) / kBlockDimension;
+	size_t blockSize = GetBlockSize(format);
+	std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+
+	for (size_t blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (size_t blockX = 0; blockX < blocksX; blockX++)
+		{
+			const uint8_t *block = blocks + (blockY * blocksX + blockX) * blockSize;
+			uint8_t pixels[kBlockPixels * 4] = {};
+			switch (format)
+			{
+			case Format::BC1:
+				DecodeColorBlock(block, pixels);
+				break;
+			case Format::BC3:
+				DecodeColorBlock(block + 8, pixels);
+				DecodeChannelBlock(block, 3, pixels);
+				break;
+			case Format::BC5:
+				DecodeChannelBlock(block, 0, pixels);
+				DecodeChannelBlock(block + 8, 1, pixels);
+				break;
+			}
+
+			for (int y = 0; y < kBlockDimension; y++)
+			{
+				for (int x = 0; x < kBlockDimension; x++)
+				{
+					size_t targetX = blockX * kBlockDimension + x;
+					size_t targetY = blockY * kBlockDimension + y;
+					if (targetX >= static_cast<size_t>(width) || targetY >= static_cast<size_t>(height)) continue;
+					std::memcpy(rgba.data() + (targetY * width + targetX) * 4, pixels + (y * kBlockDimension + x) * 4, 4);
+				}
+			}
+		}
+	}
+	return rgba;
+}
@@ -0,0 +1,170 @@
+#include "PackWriter.h"
+
+#include <Engine/FileSystem.h>
+#include <Engine/JobSystem.h>
+#include <Engine/LZ4.h>
+#include <Engine/MappedFile.h>
+#include <Engine/PackFile.h>
+#include <Engine/Profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	struct PendingEntry
+	{
+		std::string path;
+		std::string name;
+		int64_t time = 0;
+		MappedFile file;
+		std::vector<char> compressed;
+		bool useCompressed = false;
+		PackFile::IndexRecord record = {};
+	};
+
+	uint64_t AlignUp(uint64_t value)
+	{
+		return (value + PackFile::kDataAlignment - 1) & ~uint64_t(PackFile::kDataAlignment - 1);
+	}
+}
+
+bool PackWriter::Write(const std::string &directory, const std::string &outputPath, bool compress, Result &result)
+{
+	PROFILE_SCOPE("PackWriter::Write");
+	auto start = std::chrono::steady_clock::now();
+	result = Result();
+
+	if (!std::filesystem::is_directory(directory))
+	{
+		std::cerr << "No such directory: " << directory << std::endl;
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::path outputFile = std::filesystem::weakly_canonical(outputPath, error);
+
+	std::vector<PendingEntry> entries;
+	for (const auto &file : std::filesystem::recursive_directory_iterator(directory))
+	{
+		if (!file.is_regular_file()) continue;
+
+		// Leftovers of interrupted cooks and packs, and the pack itself when written into the directory
+		std::string extension = file.path().extension().string();
+		if (extension == ".tmp" || extension == ".gk1pak") continue;
+		if (std::filesystem::weakly_canonical(file.path(), error) == outputFile) continue;
+
+		PendingEntry &entry = entries.emplace_back();
+		entry.path = file.path().string();
+		entry.name = FileSystem::Normalize(entry.path);
+		entry.time = file.last_write_time().time_since_epoch().count();
+	}
+
+	if (entries.empty())
+	{
+		std::cerr << "No files to pack in " << directory << std::endl;
+		return false;
+	}
+
+	// Sorted names keep the files of one model or material next to each other in the pack
+	std::sort(entries.begin(), entries.end(), [](const PendingEntry &a, const PendingEntry &b) { return a.name < b.name; });
+	for (size_t i = 1; i < entries.size(); i++)
+	{
+		if (entries[i].name == entries[i - 1].name)
+		{
+			std::cerr << "Paths differing only in case cannot be packed: " << entries[i].path << std::endl;
+			return false;
+		}
+	}
+
+	JobSystem::Get().ParallelFor(entries.size(), [&entries, compress](size_t i)
+		{
+			PendingEntry &entry = entries[i];
+			if (!entry.file.Open(entry.path) || !compress || entry.file.GetSize() == 0) return;
+
+			entry.compressed = LZ4::Compress(entry.file.GetData(), entry.file.GetSize());
+			entry.useCompressed = entry.compressed.size() <= entry.file.GetSize() * kMaxCompressedRatio;
+			if (!entry.useCompressed)
+				std::vector<char>().swap(entry.compressed);
+		});
+
+	for (const auto &entry : entries)
+	{
+		if (!entry.file.IsOpen())
+		{
+			std::cerr << "Failed to read " << entry.path << std::endl;
+			return false;
+		}
+	}
+
+	// Write to a temporary file first so a crash never leaves a truncated pack behind
+	std::string tempPath = outputPath + ".tmp";
+	bool success;
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out) return false;
+
+		PackFile::Header header = {};
+		std::memcpy(header.magic, PackFile::kMagic, sizeof(header.magic));
+		header.version = PackFile::kVersion;
+		header.entryCount = static_cast<uint32_t>(entries.size());
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+		static const char kZeros[PackFile::kDataAlignment] = {};
+		uint64_t offset = sizeof(header);
+		for (auto &entry : entries)
+		{
+			uint64_t aligned = AlignUp(offset);
+			out.write(kZeros, aligned - offset);
+
+			std::string_view data = entry.useCompressed
+				? std::string_view(entry.compressed.data(), entry.compressed.size())
+				: entry.file.GetView();
+			out.write(data.data(), data.size());
+
+			entry.record.offset = aligned;
+			entry.record.storedSize = data.size();
+			entry.record.size = entry.file.GetSize();
+			entry.record.time = entry.time;
+			entry.record.compression = entry.useCompressed ? PackFile::Compression::LZ4 : PackFile::Compression::None;
+			entry.record.pathLength = static_cast<uint32_t>(entry.name.size());
+			offset = aligned + data.size();
+
+			result.entryCount++;
+			result.compressedCount += entry.useCompressed ? 1 : 0;
+			result.sourceBytes += entry.file.GetSize();
+		}
+
+		header.indexOffset = offset;
+		for (const auto &entry : entries)
+		{
+			out.write(reinterpret_cast<const char *>(&entry.record), sizeof(entry.record));
+			out.write(entry.name.data(), entry.name.size());
+			offset += sizeof(entry.record) + entry.name.size();
+		}
+		header.indexSize = offset - header.indexOffset;
+
+		out.seekp(0);
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		success = static_cast<bool>(out);
+		result.packBytes = offset;
+	}
+
+	if (success)
+	{
+		std::filesystem::rename(tempPath, outputPath, error);
+	}
+	if (!success || error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
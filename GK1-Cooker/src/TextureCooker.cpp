@@ -0,0 +1,448 @@
+#include "TextureCooker.h"
+#include <Engine/JobSystem.h>
+#include <Engine/Loader/Texture/KTX2Loader.h>
+#include <Engine/Profiler.h>
+#include <Engine/Resource/MipGenerator.h>
+#include <Engine/Resource/Texture.h>
+#include <Engine/Resource/TextureCache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <system_error>
+
+namespace
+{
+	// Data Format Descriptor values, see the Khronos Data Format Specification
+	constexpr uint32_t kModelRGBSDA = 1;
+	constexpr uint32_t kModelBC1 = 128;
+	constexpr uint32_t kModelBC3 = 130;
+	constexpr uint32_t kModelBC5 = 132;
+	constexpr uint32_t kPrimariesBT709 = 1;
+	constexpr uint32_t kTransferLinear = 1;
+	constexpr uint32_t kChannelColor = 0;
+	constexpr uint32_t kChannelRed = 0;
+	constexpr uint32_t kChannelGreen = 1;
+	constexpr uint32_t kChannelBlue = 2;
+	constexpr uint32_t kChannelAlpha = 15;
+	constexpr uint32_t kChannelBC3Alpha = 15;
+
+	Texture::Image ToRGBA(const Texture::Image &image)
+	{
+		size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+		Texture::Image rgba;
+		rgba.pixels.reset(static_cast<uint8_t *>(std::malloc(pixelCount * 4)));
+		rgba.width = image.width;
+		rgba.height = image.height;
+		rgba.channels = 4;
+
+		const uint8_t *source = image.pixels.get();
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			const uint8_t *pixel = source + i * image.channels;
+			uint8_t *target = rgba.pixels.get() + i * 4;
+			// Gray and gray-alpha images are spread to all color channels
+			target[0] = pixel[0];
+			target[1] = image.channels >= 3 ? pixel[1] : pixel[0];
+			target[2] = image.channels >= 3 ? pixel[2] : pixel[0];
+			target[3] = image.channels == 4 ? pixel[3] : image.channels == 2 ? pixel[1] : 255;
+		}
+		return rgba;
+	}
+
+	std::vector<uint32_t> BuildDescriptor(uint32_t vkFormat)
+	{
+		struct Sample
+		{
+			uint32_t bitOffset;
+			uint32_t bitLength;
+			uint32_t channel;
+		};
+
+		uint32_t colorModel = kModelRGBSDA;
+		uint32_t blockDimensions = 0;
+		uint32_t bytesPlane0;
+		std::vector<Sample> samples;
+		switch (vkFormat)
+		{
+		case KTX2Loader::kFormatBC1:
+			colorModel = kModelBC1;
+			samples = { { 0, 64, kChannelColor } };
+			break;
+		case KTX2Loader::kFormatBC3:
+			colorModel = kModelBC3;
+			samples = { { 0, 64, kChannelBC3Alpha }, { 64, 64, kChannelColor } };
+			break;
+		case KTX2Loader::kFormatBC5:
+			colorModel = kModelBC5;
+			samples = { { 0, 64, kChannelRed }, { 64, 64, kChannelGreen } };
+			break;
+		default:
+		{
+			static constexpr uint32_t kChannels[4] = { kChannelRed, kChannelGreen, kChannelBlue, kChannelAlpha };
+			for (int c = 0; c < KTX2Loader::GetPixelChannels(vkFormat); c++)
+				samples.push_back({ 8u * c, 8, kChannels[c] });
+			break;
+		}
+		}
+
+		if (colorModel != kModelRGBSDA)
+		{
+			// 4x4 blocks, dimensions are stored minus one
+			blockDimensions = 3 | 3 << 8;
+			bytesPlane0 = static_cast<uint32_t>(samples.size() * 8);
+		}
+		else
+		{
+			bytesPlane0 = static_cast<uint32_t>(samples.size());
+		}
+
+		// One basic descriptor block
+		uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+		std::vector<uint32_t> descriptor = {
+			4 + blockSize,
+			0,
+			2 | blockSize << 16,
+			colorModel | kPrimariesBT709 << 8 | kTransferLinear << 16,
+			blockDimensions,
+			bytesPlane0,
+			0
+		};
+		for (const auto &sample : samples)
+		{
+			uint32_t upper = sample.bitLength == 8 ? 255u : UINT32_MAX;
+			descriptor.insert(descriptor.end(), { sample.bitOffset | (sample.bitLength - 1) << 16 | sample.channel << 24, 0u, 0u, upper });
+		}
+		return descriptor;
+	}
+
+	void AppendKeyValue(std::string &data, const std::string &key, const std::string &value)
+	{
+		uint32_t length = static_cast<uint32_t>(key.size() + value.size() + 2);
+		data.append(reinterpret_cast<const char *>(&length), sizeof(length));
+		data += key;
+		data += '\0';
+		data += value;
+		data += '\0';
+		data.resize((data.size() + 3) & ~size_t(3), '\0');
+	}
+
+	size_t AlignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	uint32_t GetVkFormat(BlockEncoder::Format format)
+	{
+		switch (format)
+		{
+		case BlockEncoder::Format::BC1:
+			return KTX2Loader::kFormatBC1;
+		case BlockEncoder::Format::BC3:
+			return KTX2Loader::kFormatBC3;
+		default:
+			return KTX2Loader::kFormatBC5;
+		}
+	}
+
+	// Splits an image with levels into one buffer per level
+	std::vector<std::vector<uint8_t>> SplitLevels(const Texture::Image &image)
+	{
+		std::vector<std::vector<uint8_t>> levels;
+		const uint8_t *level = image.pixels.get();
+		for (size_t size : image.levelSizes)
+		{
+			levels.emplace_back(level, level + size);
+			level += size;
+		}
+		return levels;
+	}
+}
+
+bool TextureCooker::Cook(const std::string &sourcePath, Usage usage, bool compress, Result &result)
+{
+	PROFILE_SCOPE("TextureCooker::Cook");
+	auto start = std::chrono::steady_clock::now();
+
+	// Decoded bottom-up exactly like the engine uploads the source, the file is marked accordingly
+	Texture::Image image;
+	if (!Texture::Decode(sourcePath, Texture::TextureType::Diffuse, image))
+	{
+		return false;
+	}
+	if (image.compressedFormat != 0)
+	{
+		std::cerr << "Source is already block-compressed: " << sourcePath << std::endl;
+		return false;
+	}
+
+	// Same levels the engine would build at load time
+	Texture::TextureType type = usage == Usage::Normal ? Texture::TextureType::Normal : Texture::TextureType::Diffuse;
+	result.width = image.width;
+	result.height = image.height;
+	result.compressed = compress;
+
+	std::vector<std::vector<uint8_t>> levels;
+	uint32_t vkFormat;
+	if (compress)
+	{
+		Texture::Image rgba = ToRGBA(image);
+		result.channels = image.channels;
+		image = Texture::Image();
+
+		bool translucent = false;
+		size_t baseSize = static_cast<size_t>(rgba.width) * rgba.height * 4;
+		for (size_t i = 3; i < baseSize && !translucent; i += 4)
+			translucent = rgba.pixels.get()[i] != 255;
+		result.format = usage == Usage::Normal ? BlockEncoder::Format::BC5 : translucent ? BlockEncoder::Format::BC3 : BlockEncoder::Format::BC1;
+		vkFormat = GetVkFormat(result.format);
+
+		// Compressed textures cannot have their mips generated on the GPU, so the whole chain is stored
+		MipGenerator::Generate(rgba, type);
+		result.sourceBytes = Texture::GetByteSize(rgba, type) / 4 * result.channels;
+		const uint8_t *level = rgba.pixels.get();
+		for (size_t i = 0; i < rgba.levelSizes.size(); i++)
+		{
+			int width = std::max(1, rgba.width >> i);
+			int height = std::max(1, rgba.height >> i);
+			levels.push_back(BlockEncoder::Encode(result.format, level, width, height));
+			if (i == 0)
+			{
+				result.psnr = ComputePSNR(result.format, level, BlockEncoder::Decode(result.format, levels[0].data(), width, height));
+			}
+			level += rgba.levelSizes[i];
+		}
+	}
+	else
+	{
+		result.channels = image.channels;
+		vkFormat = image.channels == 1 ? KTX2Loader::kFormatR8 : image.channels == 2 ? KTX2Loader::kFormatRG8
+			: image.channels == 3 ? KTX2Loader::kFormatRGB8 : KTX2Loader::kFormatRGBA8;
+		MipGenerator::Generate(image, type);
+		result.sourceBytes = Texture::GetByteSize(image, type);
+		levels = SplitLevels(image);
+	}
+
+	result.cookedPath = TextureCache::GetCookedPath(sourcePath);
+	if (!WriteKTX2(result.cookedPath, vkFormat, result.width, result.height, 0, levels))
+	{
+		std::cerr << "Failed to write " << result.cookedPath << std::endl;
+		return false;
+	}
+
+	result.levels = static_cast<int>(levels.size());
+	result.cookedBytes = 0;
+	for (const auto &level : levels)
+		result.cookedBytes += level.size();
+	result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+bool TextureCooker::CookCubemapArray(const std::vector<std::string> &facePaths, const std::string &outputPath, bool compress, Result &result)
+{
+	PROFILE_SCOPE("TextureCooker::CookCubemapArray");
+	auto start = std::chrono::steady_clock::now();
+
+	if (facePaths.empty() || facePaths.size() % 6 != 0)
+	{
+		std::cerr << "A cubemap array needs six faces per cube, got " << facePaths.size() << std::endl;
+		return false;
+	}
+
+	// Top row first, like the engine decodes cubemap faces
+	std::vector<Texture::Image> faces(facePaths.size());
+	std::vector<char> decoded(facePaths.size());
+	JobSystem::Get().ParallelFor(faces.size(), [&facePaths, &faces, &decoded](size_t i)
+		{
+			decoded[i] = Texture::Decode(facePaths[i], Texture::TextureType::Cubemap, faces[i]);
+		});
+
+	bool sameChannels = true;
+	for (size_t i = 0; i < faces.size(); i++)
+	{
+		if (!decoded[i])
+		{
+			return false;
+		}
+		if (faces[i].compressedFormat != 0 || faces[i].width != faces[i].height || faces[i].width != faces[0].width)
+		{
+			std::cerr << "Cubemap faces must be uncompressed squares of one size: " << facePaths[i] << std::endl;
+			return false;
+		}
+		sameChannels = sameChannels && faces[i].channels == faces[0].channels;
+	}
+
+	result.width = faces[0].width;
+	result.height = faces[0].height;
+	result.compressed = compress;
+	result.levels = 1;
+	result.sourceBytes = 0;
+	for (const auto &face : faces)
+		result.sourceBytes += Texture::GetByteSize(face, Texture::TextureType::Cubemap);
+
+	// Layer-faces follow each other within the level
+	std::vector<std::vector<uint8_t>> levels(1);
+	std::vector<uint8_t> &level = levels[0];
+	uint32_t vkFormat;
+	if (compress || !sameChannels)
+	{
+		std::vector<Texture::Image> rgbaFaces;
+		bool translucent = false;
+		for (auto &face : faces)
+		{
+			rgbaFaces.push_back(ToRGBA(face));
+			face = Texture::Image();
+
+			size_t faceSize = static_cast<size_t>(result.width) * result.height * 4;
+			for (size_t i = 3; i < faceSize && !translucent; i += 4)
+				translucent = rgbaFaces.back().pixels.get()[i] != 255;
+		}
+		result.channels = 4;
+		result.format = translucent ? BlockEncoder::Format::BC3 : BlockEncoder::Format::BC1;
+		vkFormat = compress ? GetVkFormat(result.format) : KTX2Loader::kFormatRGBA8;
+
+		double squaredErrorSum = 0.0;
+		for (const auto &face : rgbaFaces)
+		{
+			const uint8_t *pixels = face.pixels.get();
+			if (!compress)
+			{
+				level.insert(level.end(), pixels, pixels + static_cast<size_t>(result.width) * result.height * 4);
+				continue;
+			}
+
+			std::vector<uint8_t> blocks = BlockEncoder::Encode(result.format, pixels, result.width, result.height);
+			// Averaged as mean squared error so one noisy face does not hide behind clean ones
+			double psnr = ComputePSNR(result.format, pixels, BlockEncoder::Decode(result.format, blocks.data(), result.width, result.height));
+			squaredErrorSum += 255.0 * 255.0 / std::pow(10.0, psnr / 10.0);
+			level.insert(level.end(), blocks.begin(), blocks.end());
+		}
+		if (compress)
+		{
+			double meanSquaredError = squaredErrorSum / rgbaFaces.size();
+			result.psnr = meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+		}
+	}
+	else
+	{
+		result.channels = faces[0].channels;
+		vkFormat = result.channels == 1 ? KTX2Loader::kFormatR8 : result.channels == 2 ? KTX2Loader::kFormatRG8
+			: result.channels == 3 ? KTX2Loader::kFormatRGB8 : KTX2Loader::kFormatRGBA8;
+		for (const auto &face : faces)
+		{
+			size_t size = Texture::GetByteSize(face, Texture::TextureType::Cubemap);
+			level.insert(level.end(), face.pixels.get(), face.pixels.get() + size);
+		}
+	}
+
+	result.cookedPath = outputPath;
+	if (!WriteKTX2(outputPath, vkFormat, result.width, result.height, static_cast<int>(faces.size() / 6), levels))
+	{
+		std::cerr << "Failed to write " << outputPath << std::endl;
+		return false;
+	}
+
+	result.cookedBytes = level.size();
+	result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+double TextureCooker::ComputePSNR(BlockEncoder::Format format, const uint8_t *original, const std::vector<uint8_t> &decoded)
+{
+	// BC5 only stores red and green, the shader rebuilds the rest
+	int channelCount = format == BlockEncoder::Format::BC1 ? 3 : format == BlockEncoder::Format::BC3 ? 4 : 2;
+
+	double squaredError = 0.0;
+	for (size_t i = 0; i < decoded.size(); i += 4)
+	{
+		for (int c = 0; c < channelCount; c++)
+		{
+			double difference = double(original[i + c]) - double(decoded[i + c]);
+			squaredError += difference * difference;
+		}
+	}
+
+	double meanSquaredError = squaredError / (decoded.size() / 4 * channelCount);
+	// Lossless blocks (flat colors) would be infinite
+	return meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+}
+
+bool TextureCooker::WriteKTX2(const std::string &path, uint32_t vkFormat, int width, int height, int cubeCount,
+	const std::vector<std::vector<uint8_t>> &levels)
+{
+	std::vector<uint32_t> descriptor = BuildDescriptor(vkFormat);
+	// Bytes of one block or pixel, levels start on a multiple of it and of 4
+	size_t alignment = std::lcm(static_cast<size_t>(descriptor[5] & 0xFF), size_t(4));
+
+	// Keys are sorted, rows are stored in the order the engine uploads them so it never flips
+	std::string keyValues;
+	AppendKeyValue(keyValues, "KTXorientation", cubeCount > 0 ? "rd" : "ru");
+	AppendKeyValue(keyValues, "KTXwriter", "GK1-Cooker");
+
+	KTX2Loader::Header header{};
+	std::memcpy(header.identifier, KTX2Loader::kIdentifier, sizeof(header.identifier));
+	header.vkFormat = vkFormat;
+	header.typeSize = 1;
+	header.pixelWidth = static_cast<uint32_t>(width);
+	header.pixelHeight = static_cast<uint32_t>(height);
+	header.layerCount = static_cast<uint32_t>(cubeCount);
+	header.faceCount = cubeCount > 0 ? 6 : 1;
+	header.levelCount = static_cast<uint32_t>(levels.size());
+
+	size_t offset = sizeof(header) + levels.size() * sizeof(KTX2Loader::LevelIndex);
+	header.dfdByteOffset = static_cast<uint32_t>(offset);
+	header.dfdByteLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+	offset += header.dfdByteLength;
+	header.kvdByteOffset = static_cast<uint32_t>(offset);
+	header.kvdByteLength = static_cast<uint32_t>(keyValues.size());
+	offset += header.kvdByteLength;
+
+	// The smallest level comes first in the file
+	std::vector<KTX2Loader::LevelIndex> index(levels.size());
+	for (size_t level = levels.size(); level-- > 0;)
+	{
+		offset = AlignUp(offset, alignment);
+		index[level] = { offset, levels[level].size(), levels[level].size() };
+		offset += levels[level].size();
+	}
+
+	// Write to a temporary file first so a crash never leaves a truncated texture behind
+	std::string tempPath = path + ".tmp";
+	bool success;
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out) return false;
+
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(KTX2Loader::LevelIndex));
+		out.write(reinterpret_cast<const char *>(descriptor.data()), descriptor.size() * sizeof(uint32_t));
+		out.write(keyValues.data(), keyValues.size());
+
+		static const char kZeros[16] = {};
+		size_t written = static_cast<size_t>(out.tellp());
+		for (size_t level = levels.size(); level-- > 0;)
+		{
+			out.write(kZeros, index[level].byteOffset - written);
+			out.write(reinterpret_cast<const char *>(levels[level].data()), levels[level].size());
+			written = index[level].byteOffset + levels[level].size();
+		}
+		success = static_cast<bool>(out);
+	}
+
+	std::error_code error;
+	if (success)
+	{
+		std::filesystem::rename(tempPath, path, error);
+	}
+	if (!success || error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <string>
+#include "PackWriter.h"
+#include "TextureCooker.h"
+#include <Engine/Profiler.h>
+#include <Engine/Resource/TextureCache.h>
+
+static void PrintUsage()
+{
+	std::cerr << "Usage: GK1-Cooker [options] <image|directory>...\n"
+		<< "  --color                  Cook the images that follow as color maps, BC1 or BC3 with alpha (default)\n"
+		<< "  --normal                 Cook the images that follow as normal maps, BC5\n"
+		<< "  --uncompressed           Keep the 8-bit source channels and only store the generated mip chain\n"
+		<< "  --cubemap-array <out.ktx2> <faces>...\n"
+		<< "                           Cook the following faces, six per cube in +X -X +Y -Y +Z -Z order, into one\n"
+		<< "                           cubemap array\n"
+		<< "  --pack <out.gk1pak> <directory>\n"
+		<< "                           After cooking, pack every file below the directory for FileSystem::Mount.\n"
+		<< "                           Run from the game's working directory, entries are named as the game loads them\n"
+		<< "  --no-lz4                 Store all pack entries uncompressed\n"
+		<< "  --force                  Cook even if the cooked file is newer than its source\n"
+		<< "  --trace <file>           Write a chrome://tracing profile of the run\n"
+		<< "Directories are searched for .mtl files. Textures in their normal map slots are cooked as\n"
+		<< "normal maps, the other texture slots as color maps.\n";
+}
+
+// Collects the textures MTLLoader loads from every material library below a directory
+static void CollectMaterialTextures(const std::filesystem::path &directory, std::map<std::string, TextureCooker::Usage> &textures)
+{
+	for (const auto &entry : std::filesystem::recursive_directory_iterator(directory))
+	{
+		if (!entry.is_regular_file() || entry.path().extension() != ".mtl") continue;
+
+		std::ifstream file(entry.path());
+		std::string line;
+		while (std::getline(file, line))
+		{
+			std::istringstream iss(line);
+			std::string token, texture;
+			iss >> token >> texture;
+
+			TextureCooker::Usage usage;
+			if (token == "map_Ka" || token == "map_Kd" || token == "map_Ks")
+				usage = TextureCooker::Usage::Color;
+			else if (token == "map_Kn" || token == "norm")
+				usage = TextureCooker::Usage::Normal;
+			else
+				continue;
+
+			// Some exporters write Windows separators
+			std::replace(texture.begin(), texture.end(), '\\', '/');
+			std::string path = (entry.path().parent_path() / texture).lexically_normal().string();
+			if (!std::filesystem::exists(path))
+			{
+				// The engine falls back to a default texture for these as well
+				std::cerr << "Skipping missing texture referenced by " << entry.path().string() << ": " << path << std::endl;
+				continue;
+			}
+
+			auto [it, inserted] = textures.emplace(path, usage);
+			if (!inserted && it->second != usage)
+			{
+				std::cerr << "Texture used as color and normal map, cooking it as a normal map: " << path << std::endl;
+				it->second = TextureCooker::Usage::Normal;
+			}
+		}
+	}
+}
+
+static const char *GetFormatName(const TextureCooker::Result &result)
+{
+	if (!result.compressed)
+	{
+		static const char *kNames[4] = { "R8", "RG8", "RGB8", "RGBA8" };
+		return kNames[result.channels - 1];
+	}
+
+	switch (result.format)
+	{
+	case BlockEncoder::Format::BC1:
+		return "BC1";
+	case BlockEncoder::Format::BC3:
+		return "BC3";
+	default:
+		return "BC5";
+	}
+}
+
+int main(int argc, char **argv)
+{
+	std::map<std::string, TextureCooker::Usage> textures;
+	// Output path and faces of every --cubemap-array
+	std::vector<std::pair<std::string, std::vector<std::string>>> cubemapArrays;
+	TextureCooker::Usage usage = TextureCooker::Usage::Color;
+	bool force = false;
+	bool compress = true;
+	bool compressPack = true;
+	std::string tracePath;
+	// Output path and directory of every --pack
+	std::vector<std::pair<std::string, std::string>> packs;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--color")
+			usage = TextureCooker::Usage::Color;
+		else if (arg == "--normal")
+			usage = TextureCooker::Usage::Normal;
+		else if (arg == "--uncompressed")
+			compress = false;
+		else if (arg == "--no-lz4")
+			compressPack = false;
+		else if (arg == "--pack" && i + 2 < argc)
+		{
+			packs.emplace_back(argv[i + 1], argv[i + 2]);
+			i += 2;
+		}
+		else if (arg == "--force")
+			force = true;
+		else if (arg == "--trace" && hasValue)
+			tracePath = argv[++i];
+		else if (arg == "--cubemap-array" && hasValue)
+		{
+			auto &[outputPath, faces] = cubemapArrays.emplace_back(argv[++i], std::vector<std::string>());
+			while (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0)
+				faces.push_back(argv[++i]);
+		}
+		else if (arg.rfind("--", 0) == 0)
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+		else if (std::filesystem::is_directory(arg))
+			CollectMaterialTextures(arg, textures);
+		else if (std::filesystem::is_regular_file(arg))
+			textures[std::filesystem::path(arg).lexically_normal().string()] = usage;
+		else
+		{
+			std::cerr << "No such file or directory: " << arg << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (textures.empty() && cubemapArrays.empty() && packs.empty())
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	Profiler::SetThreadName("Main");
+	Profiler::EndStartup();
+
+	int failed = 0;
+	size_t sourceBytes = 0, cookedBytes = 0;
+	for (const auto &[path, textureUsage] : textures)
+	{
+		if (!force && TextureCache::IsCookedUpToDate(path))
+		{
+			std::cout << path << ": up to date" << std::endl;
+			continue;
+		}
+
+		TextureCooker::Result result;
+		if (!TextureCooker::Cook(path, textureUsage, compress, result))
+		{
+			failed++;
+			continue;
+		}
+
+		sourceBytes += result.sourceBytes;
+		cookedBytes += result.cookedBytes;
+		std::cout << path << " -> " << result.cookedPath << ": " << GetFormatName(result) << " "
+			<< result.width << "x" << result.height << ", " << result.levels << " levels, "
+			<< result.sourceBytes / 1024 << " KB -> " << result.cookedBytes / 1024 << " KB, ";
+		if (result.compressed)
+			std::cout << "PSNR " << result.psnr << " dB, ";
+		std::cout << result.milliseconds << " ms" << std::endl;
+	}
+
+	for (const auto &[outputPath, faces] : cubemapArrays)
+	{
+		if (!force && TextureCache::IsCookedUpToDate(outputPath, faces))
+		{
+			std::cout << outputPath << ": up to date" << std::endl;
+			continue;
+		}
+
+		TextureCooker::Result result;
+		if (!TextureCooker::CookCubemapArray(faces, outputPath, compress, result))
+		{
+			failed++;
+			continue;
+		}
+
+		sourceBytes += result.sourceBytes;
+		cookedBytes += result.cookedBytes;
+		std::cout << faces.size() / 6 << " cubes -> " << outputPath << ": " << GetFormatName(result) << " "
+			<< result.width << "x" << result.height << ", " << result.sourceBytes / 1024 << " KB -> " << result.cookedBytes / 1024 << " KB, ";
+		if (result.compressed)
+			std::cout << "PSNR " << result.psnr << " dB, ";
+		std::cout << result.milliseconds << " ms" << std::endl;
+	}
+
+	if (cookedBytes > 0)
+	{
+		std::cout << "Cooked " << sourceBytes / 1024 << " KB of source pixels into " << cookedBytes / 1024 << " KB" << std::endl;
+	}
+
+	// Packed last so they contain what was just cooked
+	for (const auto &[outputPath, directory] : packs)
+	{
+		PackWriter::Result result;
+		if (!PackWriter::Write(directory, outputPath, compressPack, result))
+		{
+			std::cerr << "Failed to write pack: " << outputPath << std::endl;
+			failed++;
+			continue;
+		}
+
+		std::cout << directory << " -> " << outputPath << ": " << result.entryCount << " files, "
+			<< result.compressedCount << " LZ4-compressed, " << result.sourceBytes / 1024 << " KB -> "
+			<< result.packBytes / 1024 << " KB, " << result.milliseconds << " ms" << std::endl;
+	}
+
+	if (!tracePath.empty() && !Profiler::WriteChromeTrace(tracePath))
+		std::cerr << "Failed to write trace: " << tracePath << std::endl;
+
+	return failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
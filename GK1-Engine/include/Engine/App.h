@@ -8,7 +8,17 @@
 class App
 {
 public:
-	App(std::string title, int width, int height);
+	// Offscreen context used when no display is available (e.g. build farm benchmarks),
+	// Null runs without any context on the stub function table from NullGL
+	enum class HeadlessMode
+	{
+		None,
+		EGL,
+		OSMesa,
+		Null
+	};
+
+	App(std::string title, int width, int height, HeadlessMode headless = HeadlessMode::None);
 	virtual ~App();
 
 	void Run();
@@ -27,6 +37,8 @@ protected:
 	void SetWireframe(bool enabled) { m_Renderer->SetWireframe(enabled); }
 	bool GetWireframe() const { return m_Renderer->GetWireframe(); }
 
+	bool IsHeadless() const { return m_Headless != HeadlessMode::None; }
+
 	bool IsFixedTimeStep = false;
 	float FixedTimeStep = 1.0f / 60.0f;
 	glm::ivec2 GetViewport() const;
@@ -35,10 +47,11 @@ protected:
 	Window *GetWindow() const { return m_Window; }
 
 private:
-	void Initialize();
+	void Initialize(HeadlessMode headless);
 	void FPSCounter(float deltaTime);
 
 	bool m_IsVsync = true;
+	HeadlessMode m_Headless = HeadlessMode::None;
 	Window *m_Window;
 	Renderer *m_Renderer;
 	ResourceManager *m_ResourceManager;
@@ -0,0 +1,72 @@
+#pragma once
+#include "Engine/MappedFile.h"
+#include "Engine/PackFile.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Contents of one file: a span into a mounted pack, a decompressed pack entry or a mapped loose file.
+// Valid until the object is destroyed, even if the pack is unmounted meanwhile.
+class FileData
+{
+public:
+	const char *GetData() const { return m_view.data(); }
+	size_t GetSize() const { return m_view.size(); }
+	std::string_view GetView() const { return m_view; }
+
+private:
+	friend class FileSystem;
+
+	std::shared_ptr<const PackFile> m_pack;
+	std::unique_ptr<char[]> m_buffer;
+	MappedFile m_file;
+	std::string_view m_view;
+};
+
+// Virtual filesystem the loaders read through. Mounted packs are searched first (last mounted wins), anything
+// they do not contain falls back to loose files, so a partial pack or an unpacked working tree both work.
+class FileSystem
+{
+public:
+	struct Info
+	{
+		uint64_t size = 0;
+		// Modification time in file_time_type ticks, only meant to be compared with other Info times
+		int64_t time = 0;
+	};
+
+	struct Stats
+	{
+		uint64_t packReads = 0;
+		uint64_t diskReads = 0;
+	};
+
+	static bool Mount(const std::string &packPath);
+	static void UnmountAll();
+	static size_t GetMountedEntryCount();
+
+	static bool Read(const std::string &path, FileData &file);
+	static bool GetInfo(const std::string &path, Info &info);
+	static bool Exists(const std::string &path);
+	static bool IsPacked(const std::string &path);
+
+	// Lexically normal, relative to the working directory, forward slashes and lowercase, like Windows compares paths
+	static std::string Normalize(const std::string &path);
+
+	static Stats GetStats();
+
+private:
+	FileSystem() = default;
+
+	static std::shared_ptr<const PackFile> FindEntry(const std::string &path, const PackFile::Entry *&entry);
+
+	static std::shared_mutex s_mutex;
+	static std::vector<std::shared_ptr<const PackFile>> s_packs;
+	static std::atomic<uint64_t> s_packReads;
+	static std::atomic<uint64_t> s_diskReads;
+};
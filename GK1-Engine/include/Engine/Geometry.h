@@ -1,11 +1,13 @@
 #pragma once
 #include "Engine/Resource/Resource.h"
 #include "Engine/Objects/GraphicsObject.h"
+#include "Engine/Resource/GpuMemory.h"
 #include <glm/glm.hpp>
 #include <glad/gl.h>
+#include <span>
 #include <vector>
 
-class Geometry  {
+class Geometry : public GpuResident {
 public:
 
 	struct Vertex {
@@ -17,10 +19,21 @@ public:
 	};
 
 	Geometry();
-	explicit Geometry(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
+	explicit Geometry(std::span<const Vertex> vertices, std::span<const uint32_t> indices);
 	~Geometry();
 
-	void SetData(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
+	// Accepts vectors as well as views into mapped cooked files
+	void SetData(std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+
+	// Fills tangent and bitangent of triangle-list vertices from their positions and texture coordinates.
+	// Large meshes are split across the job system, the result does not depend on the number of threads.
+	static void CalculateTangents(std::span<Vertex> vertices, std::span<const uint32_t> indices);
+
+	// Binds the vertex array for drawing, uploading the CPU copy again if GpuMemory evicted the buffers
+	void Bind();
+
+	size_t GetGpuBytes() const override;
+	bool Evict() override;
 
 	GLuint GetVAO() const { return m_vao; }
 	GLuint GetVBO() const { return m_vbo; }
@@ -41,4 +54,5 @@ protected:
 	GLuint m_ebo;
 	size_t m_vertexCount;
 	size_t m_indexCount;
+	bool m_evicted;
 };
\ No newline at end of file
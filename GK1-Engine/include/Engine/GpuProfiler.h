@@ -0,0 +1,78 @@
+#pragma once
+#include "Engine/Profiler.h"
+
+#include <glad/gl.h>
+#include <cstdint>
+#include <vector>
+
+// GL_TIME_ELAPSED zones per render pass. Queries are read back kFrameLatency frames later and only if the
+// results are already available, so measuring never stalls the CPU on the GPU.
+// Timer queries cannot nest, an inner zone suspends its parent and the parent is resumed in a new query afterwards.
+class GpuProfiler
+{
+public:
+	struct Result
+	{
+		const char *name;
+		double milliseconds;
+	};
+
+	class ScopedZone
+	{
+	public:
+		explicit ScopedZone(const char *name) { BeginZone(name); }
+		~ScopedZone() { EndZone(); }
+
+		ScopedZone(const ScopedZone &) = delete;
+		ScopedZone &operator=(const ScopedZone &) = delete;
+	};
+
+	static constexpr int kFrameLatency = 3;
+
+	static void BeginFrame();
+	static void EndFrame();
+	static void BeginZone(const char *name);
+	static void EndZone();
+	static void Shutdown();
+
+	// Per-pass totals of the most recent frame whose queries have resolved
+	static const std::vector<Result> &GetResults() { return s_results; }
+	// Counts the frames resolved so far, frames whose queries were not ready keep the previous results
+	static uint64_t GetResolvedFrames() { return s_resolvedFrames; }
+
+private:
+	struct Occurrence
+	{
+		const char *name;
+		int64_t cpuStart;
+	};
+
+	struct Segment
+	{
+		size_t occurrence;
+		GLuint query;
+	};
+
+	struct FrameQueries
+	{
+		std::vector<GLuint> pool;
+		std::vector<Segment> segments;
+		std::vector<Occurrence> occurrences;
+		bool pending = false;
+	};
+
+	static void BeginSegment();
+	static void Resolve(FrameQueries &frame);
+
+	static FrameQueries s_frames[kFrameLatency];
+	static int s_currentFrame;
+	static std::vector<size_t> s_stack;
+	static std::vector<Result> s_results;
+	static uint64_t s_resolvedFrames;
+};
+
+#ifndef GK1_DISABLE_PROFILER
+#define GPU_PROFILE_SCOPE(name) GpuProfiler::ScopedZone PROFILE_CONCAT(gpuProfileZone, __LINE__)(name)
+#else
+#define GPU_PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed pool of worker threads for CPU work such as asset parsing. Jobs must not touch the GL context.
+class JobSystem
+{
+public:
+	static JobSystem &Get()
+	{
+		static JobSystem instance;
+		return instance;
+	}
+
+	template<typename F>
+	auto Submit(F &&job) -> std::future<std::invoke_result_t<F>>
+	{
+		using Result = std::invoke_result_t<F>;
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+		std::future<Result> future = task->get_future();
+		Enqueue([task]() { (*task)(); });
+		return future;
+	}
+
+	// Runs body(0..count-1) on the workers and the calling thread, returns when all iterations finished
+	void ParallelFor(size_t count, const std::function<void(size_t)> &body);
+
+	size_t GetWorkerCount() const { return m_workers.size(); }
+
+	JobSystem(const JobSystem &) = delete;
+	JobSystem &operator=(const JobSystem &) = delete;
+
+private:
+	JobSystem();
+	~JobSystem();
+
+	void Enqueue(std::function<void()> job);
+	void WorkerLoop(size_t index);
+
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()>> m_queue;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_stopping = false;
+};
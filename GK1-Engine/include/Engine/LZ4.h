@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// LZ4 block format (no frame header), compatible with LZ4_compress_default/LZ4_decompress_safe. The compressor is a
+// single-pass greedy matcher, fast enough for packing assets offline; decompression is what runs at load time.
+class LZ4
+{
+public:
+	static std::vector<char> Compress(const char *source, size_t size);
+	// Fails on malformed input or if the output would not be exactly size bytes
+	static bool Decompress(const char *source, size_t sourceSize, char *destination, size_t size);
+
+private:
+	LZ4() = default;
+};
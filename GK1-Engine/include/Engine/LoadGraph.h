@@ -0,0 +1,122 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Loads declared with their dependencies, e.g. model -> material library -> textures. Every node's CPU stage is
+// submitted to the job system as soon as it is added, the GL stages run on the thread calling Process() once the
+// node's own CPU stage and all of its dependencies are finished, so only GL object creation is serialized.
+// Nodes added from inside a GL stage become children of that node, which then only counts as finished once its
+// children are. Everything but the CPU stages is GL thread only.
+class LoadGraph
+{
+public:
+	using NodeId = size_t;
+	using Clock = std::chrono::steady_clock;
+
+	// Load times of the nodes finished since the previous report. The critical path is the chain of nodes that
+	// bounds the load time with unlimited cores and a free GL thread, so wall time can only approach it.
+	struct Report
+	{
+		size_t nodeCount = 0;
+		size_t failedCount = 0;
+		double wallMs = 0.0;
+		double cpuMs = 0.0;
+		double glMs = 0.0;
+		double criticalPathMs = 0.0;
+		std::vector<std::string> criticalPath;
+
+		std::string ToString() const;
+	};
+
+	LoadGraph() = default;
+
+	// cpu returns false on failure, which only counts for the report: the GL stage still runs and has to cope, e.g. by
+	// leaving a placeholder empty, and dependents run as usual. Either stage may be empty.
+	NodeId Add(const std::string &name, std::function<bool()> cpu, std::function<void()> gl,
+		const std::vector<NodeId> &dependencies = {});
+
+	// GL thread time Process() spends on GL stages per call, uploads of a large batch are spread over frames
+	static constexpr double kDefaultGlBudgetMs = 2.0;
+
+	// Runs the GL stages that became ready until the per-call budget is used up, at least one per call. Returns true
+	// once every node added so far is finished.
+	bool Process();
+	void SetGlBudget(double ms) { m_glBudgetMs = ms; }
+	double GetGlBudget() const { return m_glBudgetMs; }
+	// Waiting ignores the budget, the caller needs the result now
+	void Wait();
+	void WaitFor(NodeId node);
+	// Blocks until the node's GL stage ran, children it added may still be loading
+	void WaitForGl(NodeId node);
+
+	bool IsFinished(NodeId node) const { return node < m_nodes.size() && m_nodes[node].finished; }
+	size_t GetPendingCount() const { return m_nodes.size() - m_finishedCount; }
+	// True if every node is finished and some finished since the last TakeReport()
+	bool HasReport() const { return GetPendingCount() == 0 && m_reportBegin < m_nodes.size(); }
+	Report TakeReport();
+
+	LoadGraph(const LoadGraph &) = delete;
+	LoadGraph &operator=(const LoadGraph &) = delete;
+
+private:
+	static constexpr NodeId kNoNode = static_cast<NodeId>(-1);
+
+	struct Node
+	{
+		std::string name;
+		std::function<void()> gl;
+		NodeId parent = kNoNode;
+		std::vector<NodeId> dependencies;
+		std::vector<NodeId> dependents;
+		std::vector<NodeId> children;
+		size_t openDependencies = 0;
+		size_t openChildren = 0;
+		bool cpuDone = false;
+		bool succeeded = true;
+		bool glDone = false;
+		bool finished = false;
+
+		Clock::time_point added;
+		Clock::time_point finishTime;
+		double cpuMs = 0.0;
+		double glMs = 0.0;
+	};
+
+	struct CpuResult
+	{
+		NodeId node = 0;
+		bool success = false;
+		double ms = 0.0;
+	};
+
+	// Shared with the jobs so they never outlive the graph
+	struct ResultQueue
+	{
+		std::mutex mutex;
+		std::condition_variable ready;
+		std::vector<CpuResult> results;
+	};
+
+	bool Process(double budgetMs);
+	// Applies finished CPU stages, optionally blocking until there is at least one
+	void CollectResults(bool wait);
+	void MarkReady(NodeId node);
+	void RunGl(NodeId node);
+	void TryFinish(NodeId node);
+
+	std::deque<Node> m_nodes;
+	std::deque<NodeId> m_ready;
+	std::shared_ptr<ResultQueue> m_queue = std::make_shared<ResultQueue>();
+	// Set while a GL stage runs, nodes added meanwhile become its children
+	NodeId m_running = kNoNode;
+	size_t m_finishedCount = 0;
+	size_t m_reportBegin = 0;
+	double m_glBudgetMs = kDefaultGlBudgetMs;
+};
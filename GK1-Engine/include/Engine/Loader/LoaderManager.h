@@ -7,6 +7,10 @@
 #include "Engine/Loader/Material/MaterialLoader.h"
 #include "Engine/Loader/Material/MTLLoader.h"
 
+#include "Engine/Loader/Texture/TextureLoader.h"
+#include "Engine/Loader/Texture/DDSLoader.h"
+#include "Engine/Loader/Texture/KTX2Loader.h"
+
 class LoaderManager {
 public:
 
@@ -15,5 +19,7 @@ public:
 		// Initialize loaders
 		LoaderFactory<ModelLoader>::RegisterLoader(".obj", []() { return std::make_shared<OBJLoader>(); });
 		LoaderFactory<MaterialLoader>::RegisterLoader(".mtl", []() { return std::make_shared<MTLLoader>(); });
+		LoaderFactory<TextureLoader>::RegisterLoader(".dds", []() { return std::make_shared<DDSLoader>(); });
+		LoaderFactory<TextureLoader>::RegisterLoader(".ktx2", []() { return std::make_shared<KTX2Loader>(); });
 	}
 };
\ No newline at end of file
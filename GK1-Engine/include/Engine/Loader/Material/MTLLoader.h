@@ -1,22 +1,14 @@
 #pragma once
 #include "Engine/Loader/Material/MaterialLoader.h"
 #include <string>
-#include <unordered_map>
-#include <memory>
+#include <vector>
 
 class MTLLoader : public MaterialLoader {
 public:
-	struct MTLData {
-		std::unordered_map<std::string, std::shared_ptr<Material>> materials;
-		bool success;
-		std::string error;
-	};
-
-	std::vector<std::shared_ptr<Material>> Load(const std::string &filePath) override;
+	bool Load(const std::string &filePath, std::vector<MaterialData> &materials) override;
 
 private:
-	MTLData LoadMTL(const std::string &path);
 	glm::vec3 ParseVec3(const std::string &line);
 	float ParseFloat(const std::string &line);
 	std::string ParseTexture(const std::string &line, const std::string &mtlPath);
-};
\ No newline at end of file
+};
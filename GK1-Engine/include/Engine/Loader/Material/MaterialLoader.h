@@ -2,9 +2,19 @@
 #include "Engine/Resource/Material.h"
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
+
+// One material as described by a file. Parsing only touches the file, so it may run on the job system, and the
+// ResourceManager turns the descriptions into Materials on the GL thread.
+struct MaterialData {
+	std::string name;
+	Material::Properties properties;
+	std::vector<std::pair<Texture::TextureType, std::string>> textures;
+};
 
 class MaterialLoader {
 public:
 	virtual ~MaterialLoader() = default;
-	virtual std::vector<std::shared_ptr<Material>> Load(const std::string &filePath) = 0;
-};
\ No newline at end of file
+	virtual bool Load(const std::string &filePath, std::vector<MaterialData> &materials) = 0;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include "Engine/Objects/Model.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Cooked models (.gk1mesh) stored next to their source file. They hold the final interleaved vertices and indices of
+// every mesh, so loading one is a memory map and a buffer upload instead of parsing, smoothing and tangent generation.
+// Materials are not baked in, they are loaded again from the libraries the source referenced.
+class ModelCache
+{
+public:
+	// Bump whenever the vertex processing of a model loader changes so old cooked files are rebuilt
+	static constexpr uint32_t kVersion = 1;
+
+	static std::string GetCachePath(const std::string &sourcePath);
+
+	// Returns false if there is no cooked file or it no longer matches the source. Both are safe to call from jobs.
+	static bool Load(const std::string &sourcePath, ModelData &data);
+	static bool Write(const std::string &sourcePath, const ModelData &data);
+
+private:
+	ModelCache() = default;
+};
@@ -6,5 +6,6 @@
 class ModelLoader {
 public:
     virtual ~ModelLoader() = default;
-    virtual std::shared_ptr<Model> Load(const std::string& filePath) = 0;
+    // Runs on the job system for async loads, must not touch the GL context
+    virtual bool Load(const std::string& filePath, ModelData& data) = 0;
 };
\ No newline at end of file
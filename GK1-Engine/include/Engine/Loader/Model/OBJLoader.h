@@ -3,48 +3,41 @@
 #include "Engine/Loader/Model/ModelLoader.h"
 #include <glm/glm.hpp>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <memory>
 #include <unordered_map>
 
 class OBJLoader : public ModelLoader {
 public:
-	struct MeshData {
-		std::string name;
-		std::vector<Geometry::Vertex> vertices;
-		std::vector<uint32_t> indices;
-		std::shared_ptr<Material> material;
-	};
+	using MeshData = ModelData::MeshData;
 
-	struct OBJData {
-		std::vector<MeshData> meshes;
-		bool success;
-		std::string error;
-	};
+	// Attribute indices of one group, already triangulated and 0-based
+	struct GroupData {
+		explicit GroupData(std::string name) : name(std::move(name)) {}
 
-	std::shared_ptr<Model> Load(const std::string &filePath) override;
-
-private:
-	struct TempMeshData {
+		std::string name;
+		std::string material;
 		std::vector<uint32_t> vertexIndices;
 		std::vector<uint32_t> uvIndices;
 		std::vector<uint32_t> normalIndices;
-		std::string material;
 	};
 
-	std::vector<std::shared_ptr<Material>> m_materials;
+	// Raw contents of an OBJ file before vertices are assembled
+	struct ParsedOBJ {
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec3> normals;
+		std::vector<GroupData> groups;
+		std::vector<std::string> materialLibraries;
+	};
+
+	// Index of an attribute the face does not reference (e.g. "f 1//1")
+	static constexpr uint32_t kMissingIndex = UINT32_MAX;
+
+	bool Load(const std::string &filePath, ModelData &data) override;
 
-	OBJData LoadOBJ(const std::string &path);
-	void CalculateTangents(std::vector<Geometry::Vertex> &vertices, const std::vector<uint32_t> &indices);
-	glm::vec3 ParseVec3(const std::string &line);
-	glm::vec2 ParseVec2(const std::string &line);
-	void ParseFace(const std::string &line,
-		std::vector<uint32_t> &vertexIndices,
-		std::vector<uint32_t> &uvIndices,
-		std::vector<uint32_t> &normalIndices);
-	MeshData ProcessMeshData(const std::vector<glm::vec3> &positions,
-		const std::vector<glm::vec2> &uvs,
-		const std::vector<glm::vec3> &normals,
-		const TempMeshData &tempMesh,
-		const std::string &name);
-};
\ No newline at end of file
+	// Tokenizes OBJ text without loading materials or touching the GPU
+	static void ParseOBJ(std::string_view source, ParsedOBJ &parsed);
+	// Deduplicated vertices of one group with smoothed normals and tangents, the material is left unset
+	static MeshData ProcessMeshData(const ParsedOBJ &parsed, const GroupData &group);
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+
+// Every desktop driver exposes EXT_texture_compression_s3tc, the generated loader only lacks the enums
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// Layout of the 4x4 block formats the texture loaders accept: BC1 and BC3 for color, BC5 (two channel) for normal maps
+class BlockCompression
+{
+public:
+	static constexpr int kBlockDimension = 4;
+
+	// Returns 0 for formats that are not supported
+	static size_t GetBlockSize(GLenum format);
+	static int GetChannels(GLenum format);
+	static size_t GetLevelSize(GLenum format, int width, int height);
+
+	// Mirrors one level vertically by reordering block rows and the pixel rows inside each block. Returns false when
+	// that cannot be done without re-encoding, which is the case for heights above 4 that are not a multiple of 4.
+	static bool FlipVertically(GLenum format, uint8_t *data, int width, int height);
+
+private:
+	BlockCompression() = default;
+};
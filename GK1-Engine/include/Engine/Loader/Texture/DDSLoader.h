@@ -0,0 +1,10 @@
+#pragma once
+#include "Engine/Loader/Texture/TextureLoader.h"
+#include <string>
+
+// 2D DirectDraw Surface files with BC1 (DXT1), BC3 (DXT5) or BC5 (ATI2) blocks and optional mip levels.
+// Files are stored top to bottom, so the blocks are flipped when the engine's bottom-up orientation is requested.
+class DDSLoader : public TextureLoader {
+public:
+	bool Load(const std::string &filePath, Texture::Image &image, bool flipVertically) override;
+};
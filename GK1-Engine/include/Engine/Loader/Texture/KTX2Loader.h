@@ -0,0 +1,59 @@
+#pragma once
+#include "Engine/Loader/Texture/TextureLoader.h"
+#include <cstdint>
+#include <string>
+
+// Khronos KTX 2.0 files with BC1, BC3, BC5 blocks or 8-bit UNORM pixels and no supercompression. 2D textures, cubemaps
+// and cubemap arrays are supported, the faces of a cubemap array end up as Image::layers.
+// The KTXorientation value decides whether the levels have to be flipped, GK1-Cooker writes them bottom-up so they
+// are uploaded as-is.
+class KTX2Loader : public TextureLoader {
+public:
+	static constexpr uint8_t kIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	// VkFormat values of the formats the engine uploads
+	static constexpr uint32_t kFormatR8 = 9;
+	static constexpr uint32_t kFormatRG8 = 16;
+	static constexpr uint32_t kFormatRGB8 = 23;
+	static constexpr uint32_t kFormatRGBA8 = 37;
+	static constexpr uint32_t kFormatBC1 = 131;
+	static constexpr uint32_t kFormatBC1Srgb = 132;
+	static constexpr uint32_t kFormatBC3 = 137;
+	static constexpr uint32_t kFormatBC3Srgb = 138;
+	static constexpr uint32_t kFormatBC5 = 141;
+
+	// Identifier, header and index as laid out in the file, followed by one LevelIndex per level
+	struct Header
+	{
+		uint8_t identifier[12];
+		uint32_t vkFormat;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset;
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset;
+		uint64_t sgdByteLength;
+	};
+
+	struct LevelIndex
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+
+	// GL format of the block formats, 0 for everything else
+	static GLenum GetGLFormat(uint32_t vkFormat);
+	// Channels of the 8-bit pixel formats, 0 for everything else
+	static int GetPixelChannels(uint32_t vkFormat);
+
+	bool Load(const std::string &filePath, Texture::Image &image, bool flipVertically) override;
+};
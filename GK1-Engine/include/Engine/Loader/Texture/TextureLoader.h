@@ -0,0 +1,19 @@
+#pragma once
+#include "Engine/Resource/Texture.h"
+#include <string>
+
+// Loaders for texture containers stb_image does not read. They only fill a Texture::Image, so they run on the decode
+// jobs and the upload stays on the GL thread. The engine has no sRGB pipeline, sRGB formats load as their linear
+// counterparts and are sampled like the PNGs they replace.
+class TextureLoader {
+public:
+	virtual ~TextureLoader() = default;
+	// flipVertically asks for the first row to be the bottom one, like OpenGL expects
+	virtual bool Load(const std::string &filePath, Texture::Image &image, bool flipVertically) = 0;
+
+protected:
+	// Flips every level of an image. Block-compressed levels that cannot be flipped exactly are dropped together with
+	// the smaller ones. Returns false and leaves the image untouched if not even the base level can be flipped; loaders
+	// then fail rather than pass an upside-down image off as a good load, so callers fall back to the source image.
+	static bool FlipLevels(Texture::Image &image);
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file. The contents stay valid until the object is closed or destroyed.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string &path) { Open(path); }
+	~MappedFile();
+
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile &operator=(MappedFile &&other) noexcept;
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	bool Open(const std::string &path);
+	void Close();
+
+	bool IsOpen() const { return m_isOpen; }
+	const char *GetData() const { return m_data; }
+	size_t GetSize() const { return m_size; }
+	std::string_view GetView() const { return std::string_view(m_data, m_size); }
+
+private:
+	const char *m_data = nullptr;
+	size_t m_size = 0;
+	bool m_isOpen = false;
+
+#ifdef _WIN32
+	void *m_file = nullptr;
+	void *m_mapping = nullptr;
+#endif
+};
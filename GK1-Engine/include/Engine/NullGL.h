@@ -0,0 +1,39 @@
+#pragma once
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stub OpenGL function table passed to gladLoadGL in place of a real context. Every entry point only counts its calls,
+// queries answer with plausible values (complete framebuffers, linked programs, sequential object names) so the engine
+// runs its whole render path on machines without a GPU and the CPU side can be measured in isolation.
+class NullGL
+{
+public:
+	struct Call
+	{
+		const char *name;
+		double count;
+	};
+
+	static constexpr size_t kMaxFunctions = 1024;
+
+	static bool Load();
+	static bool IsLoaded() { return s_loaded; }
+	static GLADapiproc GetProcAddress(const char *name);
+
+	// Closes the current frame's histogram, totals keep accumulating until ResetTotals()
+	static void EndFrame();
+	static void ResetTotals();
+
+	// Calls of the last finished frame, most frequent first
+	static std::vector<Call> GetFrameHistogram();
+	// Average calls per frame since ResetTotals()
+	static std::vector<Call> GetAverageHistogram();
+	static uint64_t GetFrameCallCount();
+
+private:
+	NullGL() = default;
+
+	static bool s_loaded;
+};
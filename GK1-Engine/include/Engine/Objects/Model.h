@@ -4,24 +4,63 @@
 #include "Engine/Resource/Material.h"
 #include "Engine/Objects/GraphicsObject.h"
 #include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
-class Model : public GraphicsObject {
+class FileData;
+
+// CPU side of a model, filled by loaders and the model cache without touching the GL context
+struct ModelData
+{
+	struct MeshData
+	{
+		std::string name;
+		// Looked up by name in the material libraries, empty or unknown names get the default material
+		std::string material;
+		// Filled by loaders
+		std::vector<Geometry::Vertex> vertices;
+		std::vector<uint32_t> indices;
+		// Views into the cooked file when the mesh comes from the model cache, the vectors stay empty then
+		std::span<const Geometry::Vertex> cookedVertices;
+		std::span<const uint32_t> cookedIndices;
+
+		std::span<const Geometry::Vertex> GetVertices() const { return cookedVertices.data() ? cookedVertices : std::span<const Geometry::Vertex>(vertices); }
+		std::span<const uint32_t> GetIndices() const { return cookedIndices.data() ? cookedIndices : std::span<const uint32_t>(indices); }
+	};
+
+	std::vector<MeshData> meshes;
+	std::vector<std::string> materialLibraries;
+	// Keeps the cooked file mapped for the mesh views until the data is released
+	std::shared_ptr<const FileData> file;
+};
+
+class Model : public Resource, public GraphicsObject {
 public:
 
 	Model();
 	~Model() override;
 
 	static std::shared_ptr<Model> LoadFromFile(const std::string &path);
+	// The cooked copy if it is up to date, otherwise the source through its loader, cooking it for the next run.
+	// Safe to call from jobs.
+	static bool LoadData(const std::string &path, ModelData &data);
+	// Replaces the meshes with buffers and materials created from the data, GL thread only
+	void Build(const ModelData &data);
 	void Draw() override;
 
 	void AddMesh(const Mesh &entry);
 	const std::vector<std::shared_ptr<Mesh>> &GetMeshes() const { return m_meshes; }
 	std::shared_ptr<Mesh> GetMesh(const std::string &name) const;
 
+	// Material files the meshes' materials were loaded from, kept so cooked models can resolve them again
+	void AddMaterialLibrary(const std::string &path) { m_materialLibraries.push_back(path); }
+	const std::vector<std::string> &GetMaterialLibraries() const { return m_materialLibraries; }
+
 	glm::vec3 GetMinBounds() const;
 	glm::vec3 GetMaxBounds() const;
 
 private:
 	std::vector<std::shared_ptr<Mesh>> m_meshes;
+	std::vector<std::string> m_materialLibraries;
 };
\ No newline at end of file
@@ -15,6 +15,7 @@ public:
 	void Draw() override;
 
 	void SetShader(std::shared_ptr<Shader> shader) { m_shader = shader; }
+	// A cubemap array holds the day sky in its first cube and the night sky in its second, no night cubemap is needed
 	void SetCubemap(std::shared_ptr<Texture> cubemap) { m_dayCubemap = cubemap; }
 	void SetNightCubemap(std::shared_ptr<Texture> cubemap) { m_nightCubemap = cubemap; }
 	std::shared_ptr<Texture> GetCubemap() const { return m_dayCubemap; }
@@ -33,4 +34,5 @@ private:
 	std::shared_ptr<Texture> m_nightCubemap;
 	float m_blendFactor = 1.0f;
 	std::shared_ptr<Shader> m_shader;
+	std::shared_ptr<Shader> m_arrayShader;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#include "Engine/MappedFile.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Read side of the .gk1pak archives written by GK1-Cooker --pack. The archive is mapped once and its index maps
+// normalized paths to entries; entry data is aligned so uncompressed entries can be parsed in place.
+class PackFile
+{
+public:
+	static constexpr char kMagic[4] = { 'G', 'K', '1', 'P' };
+	static constexpr uint32_t kVersion = 1;
+	static constexpr size_t kDataAlignment = 16;
+
+	enum class Compression : uint32_t
+	{
+		None = 0,
+		LZ4 = 1
+	};
+
+	// File layout: Header, aligned entry data, then the index of one IndexRecord plus path bytes per entry
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t reserved;
+		uint64_t indexOffset;
+		uint64_t indexSize;
+	};
+
+	struct IndexRecord
+	{
+		uint64_t offset;
+		uint64_t storedSize;
+		uint64_t size;
+		// Source modification time, in the same ticks FileSystem::GetInfo reports for loose files
+		int64_t time;
+		Compression compression;
+		uint32_t pathLength;
+	};
+
+	struct Entry
+	{
+		uint64_t offset;
+		uint64_t storedSize;
+		uint64_t size;
+		int64_t time;
+		Compression compression;
+	};
+
+	bool Open(const std::string &path);
+
+	// Path must already be normalized with FileSystem::Normalize
+	const Entry *Find(const std::string &path) const;
+	std::string_view GetStoredData(const Entry &entry) const;
+	size_t GetEntryCount() const { return m_entries.size(); }
+	const std::string &GetPath() const { return m_path; }
+
+private:
+	std::string m_path;
+	MappedFile m_file;
+	std::unordered_map<std::string, Entry> m_entries;
+};
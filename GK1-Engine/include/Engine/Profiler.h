@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Scoped CPU zones recorded into a per-thread ring buffer and exported as a chrome://tracing / Perfetto JSON.
+// Everything recorded before EndStartup() is kept in full so the whole OnLoad/OnStart phase survives in the dump.
+class Profiler
+{
+public:
+	struct Zone
+	{
+		const char *name;
+		int64_t start;    // ns since profiler epoch
+		int64_t duration; // ns
+	};
+
+	class ScopedZone
+	{
+	public:
+		explicit ScopedZone(const char *name) : m_name(name), m_start(Now()) {}
+		~ScopedZone() { Record(m_name, m_start, Now()); }
+
+		ScopedZone(const ScopedZone &) = delete;
+		ScopedZone &operator=(const ScopedZone &) = delete;
+
+	private:
+		const char *m_name;
+		int64_t m_start;
+	};
+
+	static constexpr size_t kRingCapacity = 1 << 16;
+
+	static int64_t Now();
+	static void Record(const char *name, int64_t start, int64_t end);
+	// GPU time of a zone placed at the CPU time it was issued, shown on a separate "GPU" track
+	static void RecordGpu(const char *name, int64_t start, int64_t duration);
+	static void SetThreadName(const std::string &name);
+
+	static void EndStartup();
+	static bool IsCapturingStartup();
+
+	static bool WriteChromeTrace(const std::string &path);
+
+private:
+	Profiler() = default;
+};
+
+#ifndef GK1_DISABLE_PROFILER
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) Profiler::ScopedZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+#include <glad/gl.h>
+#include <cstdint>
+
+// Per-frame renderer counters. The draw paths increment Current(), EndFrame() publishes them as Last() for the HUD.
+class RenderStats
+{
+public:
+	struct Counters
+	{
+		uint32_t drawCalls = 0;
+		uint64_t triangles = 0;
+		uint64_t patches = 0;
+		uint32_t programChanges = 0;
+		uint32_t textureBinds = 0;
+		uint32_t uniformUploads = 0;
+		uint64_t bufferBytes = 0;
+		uint64_t textureBytes = 0;
+	};
+
+	static Counters &Current() { return s_current; }
+	static const Counters &Last() { return s_last; }
+
+	static void AddDraw(GLenum mode, uint64_t primitives);
+	static void UseProgram(GLuint program);
+	static void BindTexture(GLuint slot, GLuint texture);
+	static void AddBufferUpload(uint64_t bytes) { s_current.bufferBytes += bytes; }
+	static void AddTextureUpload(uint64_t bytes) { s_current.textureBytes += bytes; }
+
+	static void EndFrame();
+
+private:
+	RenderStats() = default;
+
+	static Counters s_current;
+	static Counters s_last;
+	static GLuint s_lastProgram;
+	// Texture names are unique across targets, so one per unit is enough
+	static constexpr GLuint kTrackedSlots = 32;
+	static GLuint s_lastTextures[kTrackedSlots];
+};
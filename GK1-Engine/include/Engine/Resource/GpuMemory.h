@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GL object whose memory counts against the GpuMemory budget. Registers itself for its lifetime.
+class GpuResident
+{
+public:
+	GpuResident();
+	GpuResident(const GpuResident &);
+	GpuResident &operator=(const GpuResident &) { return *this; }
+	virtual ~GpuResident();
+
+	// Bytes currently allocated on the GPU, 0 while evicted or not uploaded yet
+	virtual size_t GetGpuBytes() const = 0;
+	// Frees the GPU memory, the object restores it on its next use. Returns false if it cannot be restored.
+	virtual bool Evict() = 0;
+
+	uint64_t GetLastUsedFrame() const { return m_lastUsedFrame; }
+
+protected:
+	// Called on every use, keeps the object from being evicted for the configured number of frames
+	void MarkUsed() const;
+
+private:
+	friend class GpuMemory;
+
+	mutable uint64_t m_lastUsedFrame;
+	size_t m_index;
+};
+
+// Tracks the GPU memory of textures, meshes and shaders against a budget. Once over it, objects not used for the
+// eviction age are evicted least recently used first, so data the current scene does not draw makes room for
+// what it does. GL thread only.
+class GpuMemory
+{
+public:
+	static constexpr size_t kDefaultBudget = 1536ull * 1024 * 1024;
+	static constexpr uint64_t kDefaultEvictionAge = 300;
+
+	struct Stats
+	{
+		size_t bytes = 0;
+		size_t objects = 0;
+		uint64_t evictions = 0;
+		uint64_t restores = 0;
+	};
+
+	// Starts the next frame and evicts while over budget, called once per frame by ResourceManager::ProcessLoads
+	static void Update();
+
+	static void SetBudget(size_t bytes) { s_budget = bytes; }
+	static size_t GetBudget() { return s_budget; }
+	static void SetEvictionAge(uint64_t frames) { s_evictionAge = frames; }
+	static uint64_t GetEvictionAge() { return s_evictionAge; }
+	static uint64_t GetFrame() { return s_frame; }
+	// As of the last Update
+	static Stats GetStats();
+
+	// Counted by objects that bring evicted memory back
+	static void AddRestore() { s_restores++; }
+
+private:
+	friend class GpuResident;
+
+	static std::vector<GpuResident *> s_residents;
+	static size_t s_budget;
+	static uint64_t s_evictionAge;
+	static uint64_t s_frame;
+	static size_t s_bytes;
+	static uint64_t s_evictions;
+	static uint64_t s_restores;
+	static bool s_overBudget;
+};
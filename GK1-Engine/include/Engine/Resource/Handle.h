@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Reference to a resource registered in the ResourceManager: a slot index into the dense array for T and the
+// generation of that slot. Removing the resource bumps the generation, so stale handles resolve to nullptr instead
+// of to whatever reuses the slot. Default constructed handles are invalid.
+template<typename T>
+class Handle
+{
+public:
+	Handle() = default;
+
+	bool IsValid() const { return m_generation != 0; }
+	explicit operator bool() const { return IsValid(); }
+
+	uint32_t GetIndex() const { return m_index; }
+	uint32_t GetGeneration() const { return m_generation; }
+
+	bool operator==(const Handle &other) const = default;
+
+private:
+	friend class ResourceManager;
+
+	Handle(uint32_t index, uint32_t generation) : m_index(index), m_generation(generation) {}
+
+	uint32_t m_index = 0;
+	// Slots start at generation 1, 0 marks the invalid handle
+	uint32_t m_generation = 0;
+};
+
+template<typename T>
+struct std::hash<Handle<T>>
+{
+	size_t operator()(const Handle<T> &handle) const noexcept
+	{
+		return std::hash<uint64_t>()((static_cast<uint64_t>(handle.GetGeneration()) << 32) | handle.GetIndex());
+	}
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include "Engine/Resource/Texture.h"
+
+// Builds the mip chain of a decoded image on the CPU so loading only uploads levels. Every level is filtered from the
+// previous one with a Lanczos-2 kernel, which keeps more detail than the box filter drivers use for glGenerateMipmap
+// and gives the same result on every GPU. Normal map levels are renormalized after filtering.
+class MipGenerator
+{
+public:
+	// Appends all levels down to 1x1 to a plain single-level image, rows are filtered on the job system.
+	// Height maps are filtered at 16 bits per channel. Block-compressed, layered images and images with levels are left alone.
+	static void Generate(Texture::Image &image, Texture::TextureType type);
+
+private:
+	MipGenerator() = default;
+};
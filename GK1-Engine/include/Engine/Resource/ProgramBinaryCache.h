@@ -0,0 +1,50 @@
+#pragma once
+#include <glad/gl.h>
+#include <cstdint>
+#include <string>
+
+// Linked program binaries (glGetProgramBinary) stored on disk, so later runs load programs instead of compiling and
+// linking them. Files are keyed by the hash of the program's sources and of the GL vendor, renderer and version, so
+// a driver update or another GPU gets its own files. A binary the driver rejects anyway is deleted and the caller
+// compiles as usual. GL thread only.
+class ProgramBinaryCache
+{
+public:
+	// Bump whenever the file layout changes
+	static constexpr uint32_t kVersion = 2;
+	static constexpr const char *kDefaultDirectory = "shadercache";
+
+	struct Stats
+	{
+		uint64_t loaded = 0;
+		uint64_t stored = 0;
+		uint64_t rejected = 0;
+	};
+
+	// False when the driver offers no binary formats or after SetEnabled(false)
+	static bool IsEnabled();
+	static void SetEnabled(bool enabled) { s_enabled = enabled; }
+	static void SetDirectory(const std::string &directory) { s_directory = directory; }
+	static const std::string &GetDirectory() { return s_directory; }
+	static std::string GetCachePath(uint64_t sourceHash);
+
+	// Links program from the binary stored for sourceHash. False if there is none or the driver rejected it, the
+	// program can then be compiled and linked normally.
+	static bool Load(GLuint program, uint64_t sourceHash);
+	// Asks the driver to keep the binary of program retrievable, call before linking it
+	static void PrepareLink(GLuint program);
+	// Writes the binary of a linked program
+	static bool Store(GLuint program, uint64_t sourceHash);
+
+	static Stats GetStats() { return s_stats; }
+
+private:
+	ProgramBinaryCache() = default;
+
+	// Identifies the driver, queried once
+	static uint64_t GetDriverHash();
+
+	static bool s_enabled;
+	static std::string s_directory;
+	static Stats s_stats;
+};
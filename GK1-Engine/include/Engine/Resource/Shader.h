@@ -1,11 +1,13 @@
 #pragma once
+#include "Engine/Resource/GpuMemory.h"
 #include "Engine/Resource/Resource.h"
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <unordered_map>
 #include <memory>
 
-class Shader : public Resource {
+class Shader : public Resource, public GpuResident {
 public:
 
 	enum class ShaderType {
@@ -24,6 +26,10 @@ public:
 
 	bool AddShaderStage(ShaderType type, const std::string &source);
 	bool Link();
+	// Links from the binary ProgramBinaryCache stored for sourceHash instead of compiling stages, false if there is
+	// none. Stages can still be added and linked afterwards.
+	bool LoadBinary(uint64_t sourceHash);
+	void StoreBinary(uint64_t sourceHash) const;
 	void Use() const;
 
 	void BindUBO(const std::string &name, GLuint index);
@@ -36,6 +42,11 @@ public:
 	void SetMat3(const std::string &name, const glm::mat3 &value);
 	void SetMat4(const std::string &name, const glm::mat4 &value);
 
+	// Size of the linked program binary, the closest thing to its driver memory GL reports
+	size_t GetGpuBytes() const override { return m_programBytes; }
+	// Relinking stalls far longer than the few kilobytes are worth, programs are counted but stay resident
+	bool Evict() override { return false; }
+
 	GLuint GetID() const
 	{
 		return m_shaderProgram;
@@ -45,5 +56,6 @@ private:
 	GLint GetUniformLocation(const std::string &name);
 
 	GLuint m_shaderProgram;
+	size_t m_programBytes;
 	std::unordered_map<std::string, GLint> m_uniformLocations;
 };
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine/Resource/Shader.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Linked programs keyed by a hash of their stage sources, so every material using the default shader shares one
+// program instead of compiling and linking its own. Owned by the ResourceManager, GL thread only. Users of a shared
+// program share its uniform values and set the ones they need before drawing.
+class ShaderCache
+{
+public:
+	struct Stage
+	{
+		Shader::ShaderType type;
+		std::string_view source;
+	};
+
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		// Time spent compiling and linking the cached programs, or loading them from the ProgramBinaryCache
+		double compileMs = 0.0;
+		// Compile time the hits did not have to spend again
+		double savedMs = 0.0;
+	};
+
+	// Compiles on the first request unless the ProgramBinaryCache has the program from an earlier run, nullptr if
+	// that fails. Failures are not cached.
+	std::shared_ptr<Shader> Load(std::span<const Stage> stages);
+	std::shared_ptr<Shader> Load(std::string_view vertexSrc, std::string_view fragmentSrc);
+
+	// FNV-1a over the stage types and sources
+	static uint64_t Hash(std::span<const Stage> stages);
+
+	void Clear();
+
+	size_t GetSize() const { return m_programs.size(); }
+	Stats GetStats() const;
+
+private:
+	struct Entry
+	{
+		std::vector<Shader::ShaderType> types;
+		std::vector<std::string> sources;
+		std::shared_ptr<Shader> shader;
+		double compileMs = 0.0;
+		uint64_t hits = 0;
+	};
+
+	static bool Matches(const Entry &entry, std::span<const Stage> stages);
+
+	std::unordered_map<uint64_t, Entry> m_programs;
+	uint64_t m_hits = 0;
+	uint64_t m_misses = 0;
+};
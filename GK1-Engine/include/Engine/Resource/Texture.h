@@ -1,12 +1,15 @@
 #pragma once
+#include "Engine/Resource/GpuMemory.h"
 #include "Engine/Resource/Resource.h"
 #include <glad/gl.h>
+#include <atomic>
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
 
-class Texture : public Resource {
+class Texture : public Resource, public GpuResident {
 public:
 
 	enum class TextureType {
@@ -16,23 +19,76 @@ public:
 		Shininess,
 		Normal,
 		Height,
-		Cubemap
+		Cubemap,
+		// Several cubemaps behind one binding, loaded from a KTX2 file written by GK1-Cooker
+		CubemapArray
+	};
+
+	// Whether the decoded pixels stay in memory after the upload. Only textures read back through GetPixel need
+	// them, everything else lives on the GPU alone.
+	enum class Residency {
+		GpuOnly,
+		KeepCpuCopy
+	};
+
+	// Reported in the Performance panel, exceeding it only prints a warning
+	static constexpr size_t kDefaultCpuBudget = 32 * 1024 * 1024;
+
+	// Decoded pixels, 16 bits per channel for height maps
+	struct Image
+	{
+		std::unique_ptr<uint8_t, void (*)(void *)> pixels{ nullptr, std::free };
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		// 2D images per level, 6 per cube of a cubemap array in GL's layer-face order
+		int layers = 1;
+		// GL_COMPRESSED_* format of block-compressed data, 0 for plain pixels
+		GLenum compressedFormat = 0;
+		// Byte size of each mip level (all layers) stored back to back in pixels, base level first. Empty for a single
+		// plain level.
+		std::vector<size_t> levelSizes;
 	};
 
 	Texture();
 	~Texture();
 
-	static std::shared_ptr<Texture> LoadFromFile(const std::string &path, TextureType type = TextureType::Diffuse, bool generateMipMaps = true);
+	static std::shared_ptr<Texture> LoadFromFile(const std::string &path, TextureType type = TextureType::Diffuse, bool generateMipMaps = true,
+		Residency residency = Residency::GpuOnly);
 	static std::shared_ptr<Texture> LoadFromData(const uint8_t *data, int width, int height, int channels, TextureType type = TextureType::Diffuse, bool generateMipMaps = true);
 	static std::shared_ptr<Texture> CreateCubemap(const std::vector<std::string> &faces);
 
+	// Safe to call from any thread, only the GL upload has to happen on the main thread
+	static bool Decode(const std::string &path, TextureType type, Image &image, bool flipVertically = true);
+	// Creates the GL texture of this object from decoded pixels, which are freed afterwards unless kept for GetPixel.
+	// Missing mip levels are built by MipGenerator, the GPU never generates them.
+	void Upload(Image &&image, bool generateMipMaps, Residency residency = Residency::GpuOnly);
+	// Faces go into immutable storage in +X, -X, +Y, -Y, +Z, -Z order and must share one size and format
+	void UploadCubemap(std::vector<Image> &&faces);
+	// Evicted textures count as loaded, their pixels come back on the next Bind
+	bool IsLoaded() const { return m_textureID != 0 || m_evicted; }
+	bool IsEvicted() const { return m_evicted; }
+
+	size_t GetGpuBytes() const override { return m_textureID != 0 ? m_byteSize : 0; }
+	// Only evictable textures the TextureCache can decode again are freed, the next Bind samples the default
+	// texture and asks the cache to restore them
+	bool Evict() override;
+	void SetEvictable(bool evictable) { m_evictable = evictable; }
+	// Evicted textures bound since the last call, taken by TextureCache::ProcessUploads
+	static std::vector<Texture *> TakeRestoreRequests();
+
 	void Bind(unsigned int slot = 0) const;
-	void Unbind() const;
+	void Unbind(unsigned int slot = 0) const;
 
+	// Null unless uploaded with Residency::KeepCpuCopy
 	uint8_t *GetData() const
 	{
 		return m_data;
 	}
+	bool HasCpuData() const
+	{
+		return m_data != nullptr;
+	}
 
     template <typename T>
     requires (std::is_unsigned<T>::value && std::is_integral<T>::value && sizeof(T) < 8)
@@ -74,6 +130,25 @@ public:
 	{
 		return m_height;
 	}
+	int GetChannels() const
+	{
+		return m_channels;
+	}
+	// Cubes of a cubemap array, 1 for everything else
+	int GetLayerCount() const
+	{
+		return m_layers;
+	}
+	// Size of the uploaded data including all mip levels
+	size_t GetByteSize() const
+	{
+		return m_byteSize;
+	}
+	static size_t GetByteSize(const Image &image, TextureType type);
+	bool IsCompressed() const
+	{
+		return m_compressed;
+	}
 	TextureType GetType() const
 	{
 		return m_type;
@@ -84,6 +159,11 @@ public:
 	}
 
 	static std::shared_ptr<Texture> GetDefaultTexture(bool normalmap = false);
+
+	// Pixels of all textures kept in memory for the CPU
+	static size_t GetCpuBytes() { return s_cpuBytes; }
+	static size_t GetCpuBudget() { return s_cpuBudget; }
+	static void SetCpuBudget(size_t bytes) { s_cpuBudget = bytes; }
 private:
 
 	GLuint m_textureID;
@@ -91,7 +171,29 @@ private:
 	int m_width;
 	int m_height;
 	int m_channels;
+	int m_layers;
 	TextureType m_type;
 	GLenum m_format;
 	GLenum m_internalFormat;
+	size_t m_byteSize;
+	size_t m_cpuByteSize;
+	bool m_compressed;
+	bool m_evictable;
+	bool m_evicted;
+	mutable bool m_restoreRequested;
+
+	static std::atomic<size_t> s_cpuBytes;
+	static size_t s_cpuBudget;
+	static std::vector<Texture *> s_restoreRequests;
+
+	void UploadCubemapArray(Image &&image);
+	GLenum GetTarget() const;
+	// Binds to unit 0 for an upload and tells RenderStats, the binding outlives the upload
+	void BindForUpload(GLenum target) const;
+	void KeepData(Image &&image);
+	void ReleaseData();
+
+	static GLenum GetPixelFormat(int channels);
+	// Uploads the first levelCount levels of a block-compressed image to the bound target, returns the bytes uploaded
+	static size_t UploadCompressed(GLenum target, const Image &image, size_t levelCount);
 };
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+#include "Engine/Resource/Texture.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Textures loaded from disk keyed by their canonical path, so materials referencing the same image (or a model
+// loaded twice) share one decode and one GPU upload. Owned by the ResourceManager, used from the GL thread.
+// Async loads decode on the job system and hand the pixels back to the GL thread, which uploads them in
+// ProcessUploads(). Until then the returned texture exists but is not loaded.
+// A block-compressed file written by GK1-Cooker next to a source image replaces it as long as it is not older.
+// GPU-only 2D textures may be evicted by GpuMemory, binding one again decodes it from the same file.
+class TextureCache
+{
+public:
+	static constexpr size_t kDefaultUploadBudget = 8 * 1024 * 1024;
+
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		// Decoded image bytes that hits did not have to load and upload again
+		uint64_t bytesSaved = 0;
+	};
+
+	std::shared_ptr<Texture> Load(const std::string &path, Texture::TextureType type = Texture::TextureType::Diffuse, bool generateMipMaps = true,
+		Texture::Residency residency = Texture::Residency::GpuOnly);
+	std::shared_ptr<Texture> LoadAsync(const std::string &path, Texture::TextureType type = Texture::TextureType::Diffuse, bool generateMipMaps = true,
+		Texture::Residency residency = Texture::Residency::GpuOnly);
+	std::shared_ptr<Texture> LoadCubemapAsync(const std::vector<std::string> &faces);
+
+	// LoadAsync split for loads scheduled elsewhere, like LoadGraph nodes. Reserve returns the entry's texture and
+	// whether the caller has to fill it, Decode runs on any thread and Fill uploads its result on the GL thread.
+	// Load on a reserved entry does not wait for the owner but fills it right away, a later Fill is then dropped.
+	std::shared_ptr<Texture> Reserve(const std::string &path, Texture::TextureType type, bool generateMipMaps,
+		Texture::Residency residency, bool &reserved);
+	static bool Decode(const std::string &path, Texture::TextureType type, bool generateMipMaps, Texture::Image &image);
+	void Fill(const std::shared_ptr<Texture> &texture, const std::string &path, bool generateMipMaps, Texture::Residency residency,
+		Texture::Image &&image, bool decoded);
+
+	// Starts decodes for evicted textures bound since the last call, then uploads finished decodes in request order
+	// until the per-frame byte budget is used up. At least one texture is uploaded per call so a texture larger than
+	// the budget still arrives.
+	void ProcessUploads();
+	void SetUploadBudget(size_t bytesPerFrame) { m_uploadBudget = bytesPerFrame; }
+	size_t GetUploadBudget() const { return m_uploadBudget; }
+	// Blocks until all async loads started so far are uploaded
+	void WaitForUploads();
+	// Blocks until one texture is uploaded, uploading whatever else finishes first. Returns right away for textures
+	// this cache is not decoding, like reserved ones.
+	void WaitFor(const Texture &texture);
+	size_t GetPendingCount() const { return m_pending; }
+
+	// Evicted textures are restored first, the materials holding them outlive the cache entries
+	void Clear();
+
+	// Where GK1-Cooker stores the compressed version of a source image
+	static std::string GetCookedPath(const std::string &sourcePath);
+	// True if the cooked file exists and its source was not edited since, a missing source is fine
+	static bool IsCookedUpToDate(const std::string &sourcePath);
+	// Same for a file cooked from several sources, like a cubemap array
+	static bool IsCookedUpToDate(const std::string &cookedPath, const std::vector<std::string> &sourcePaths);
+
+	size_t GetSize() const { return m_textures.size(); }
+	Stats GetStats() const;
+
+private:
+	struct Entry
+	{
+		std::shared_ptr<Texture> texture;
+		uint64_t hits = 0;
+		// What to decode again after an eviction
+		std::string path;
+		bool generateMipMaps = false;
+		Texture::Residency residency = Texture::Residency::GpuOnly;
+		// Handed out by Reserve and not filled yet
+		bool reserved = false;
+	};
+
+	struct Decoded
+	{
+		std::string key;
+		std::shared_ptr<Texture> texture;
+		std::vector<Texture::Image> images;
+		size_t bytes = 0;
+		bool generateMipMaps = false;
+		Texture::Residency residency = Texture::Residency::GpuOnly;
+		bool success = false;
+	};
+
+	// Shared with the decode jobs so they never outlive it
+	struct UploadQueue
+	{
+		std::mutex mutex;
+		std::condition_variable ready;
+		std::vector<Decoded> decoded;
+	};
+
+	static std::string CanonicalPath(const std::string &path);
+	// The cooked file if there is an up-to-date one, height maps always come from the source
+	static std::string ResolvePath(const std::string &path, Texture::TextureType type);
+	static std::string MakeKey(const std::string &path, Texture::TextureType type, bool generateMipMaps, Texture::Residency residency);
+	std::shared_ptr<Texture> FindEntry(const std::string &key);
+	std::shared_ptr<Texture> AddEntry(const std::string &key, const std::string &path, Texture::TextureType type, bool generateMipMaps,
+		Texture::Residency residency);
+	void SubmitDecode(const std::string &key, const std::shared_ptr<Texture> &texture, const std::string &path, bool generateMipMaps,
+		Texture::Residency residency);
+	void Restore(const std::vector<Texture *> &textures);
+	// Moves finished decodes to m_ready, optionally blocking until there is at least one
+	void CollectDecoded(bool wait);
+	void Upload(Decoded &decoded);
+
+	std::unordered_map<std::string, Entry> m_textures;
+	std::shared_ptr<UploadQueue> m_queue = std::make_shared<UploadQueue>();
+	// Decoded on the GL thread's side, waiting for upload budget
+	std::deque<Decoded> m_ready;
+	size_t m_uploadBudget = kDefaultUploadBudget;
+	size_t m_pending = 0;
+	uint64_t m_hits = 0;
+	uint64_t m_misses = 0;
+};
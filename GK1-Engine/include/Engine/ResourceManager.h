@@ -1,13 +1,27 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <unordered_map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <stdexcept>
-#include <typeindex>
+#include <typeinfo>
+#include <vector>
 
+#include "Engine/LoadGraph.h"
+#include "Engine/Loader/Material/MaterialLoader.h"
+#include "Engine/Objects/Model.h"
+#include "Engine/Resource/Handle.h"
 #include "Engine/Resource/Resource.h"
+#include "Engine/Resource/ShaderCache.h"
+#include "Engine/Resource/TextureCache.h"
 #include "Concepts.h"
 
+// Named resources by type, stored in a dense slot array per type. Names are looked up once to get a Handle, which
+// then resolves with two array indices. Named resources may be added and looked up from any thread, everything that
+// loads or releases GL objects is GL thread only. Async loads run their file work on the job system through a
+// LoadGraph and are finished on the GL thread by ProcessLoads().
 class ResourceManager {
 public:
 	static ResourceManager &Get()
@@ -17,17 +31,38 @@ public:
 	}
 
 	template<IsResource T>
-	void Add(const std::string &name, std::shared_ptr<T> resource)
+	Handle<T> Add(const std::string &name, std::shared_ptr<T> resource)
 	{
-		auto typeIndex = std::type_index(typeid(T));
-		auto &resourceMap = m_resources[typeIndex];
+		std::unique_lock lock(m_mutex);
+		size_t type = GetTypeIndex<T>();
+		if (type >= m_types.size())
+		{
+			m_types.resize(type + 1);
+		}
+		auto &slots = m_types[type];
 
-		if (resourceMap.find(name) != resourceMap.end())
+		if (slots.byName.find(name) != slots.byName.end())
 		{
 			throw std::runtime_error("Resource '" + name + "' already exists!");
 		}
 
-		resourceMap[name] = resource;
+		uint32_t index;
+		if (!slots.freeSlots.empty())
+		{
+			index = slots.freeSlots.back();
+			slots.freeSlots.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(slots.slots.size());
+			slots.slots.emplace_back();
+		}
+
+		Slot &slot = slots.slots[index];
+		slot.resource = std::move(resource);
+		slot.name = name;
+		slots.byName.emplace(name, index);
+		return Handle<T>(index, slot.generation);
 	}
 
 	template<IsResource T, typename... Args>
@@ -40,80 +75,175 @@ public:
 		return resource;
 	}
 
+	// Registers a placeholder under name right away and returns it, the file is loaded into it in the background.
+	// Until then textures bind Texture::GetDefaultTexture and models have no meshes. Supported for Texture and Model.
+	// GL thread only, like the Add*Load calls.
 	template<IsResource T>
-	std::shared_ptr<T> Load(const std::string &name)
+	std::shared_ptr<T> LoadAsync(const std::string &name, const std::string &path)
 	{
-		auto typeIndex = std::type_index(typeid(T));
-		auto mapIt = m_resources.find(typeIndex);
+		static_assert(sizeof(T) == 0, "LoadAsync is only implemented for Texture and Model");
+		return nullptr;
+	}
+
+	// Async loads with dependencies, each returns its node to list as a dependency of later loads. Named resources
+	// are registered as placeholders right away. A material library decodes the textures it references as child
+	// nodes, a model is built once the libraries it depends on are finished, so models are not drawn with missing
+	// textures. Libraries a model does not depend on are loaded when it is built. A texture another load already
+	// requested returns the node filling it. GL thread only.
+	LoadGraph::NodeId AddTextureLoad(const std::string &name, const std::string &path, Texture::TextureType type = Texture::TextureType::Diffuse,
+		bool generateMipMaps = true, Texture::Residency residency = Texture::Residency::GpuOnly);
+	LoadGraph::NodeId AddMaterialLibraryLoad(const std::string &path);
+	LoadGraph::NodeId AddModelLoad(const std::string &name, const std::string &path, const std::vector<LoadGraph::NodeId> &materialLibraries = {});
+	// For nodes that are not resources, like work that has to wait for some of them
+	LoadGraph &GetLoadGraph() { return m_loadGraph; }
 
-		if (mapIt == m_resources.end())
+	// Materials of a library file, created on first use and shared by every model using the file. GL thread only.
+	std::vector<std::shared_ptr<Material>> LoadMaterialLibrary(const std::string &path);
+
+	// Finishes loads whose jobs are done, called once per frame on the GL thread. Logs the load graph report each
+	// time the graph runs empty. Also advances the GpuMemory frame, which evicts idle resources while over budget.
+	void ProcessLoads();
+	// Blocks until every async load started so far is finished, texture uploads included
+	void WaitForLoads();
+	// Blocks until one async resource is built, finishing whatever else completes first. Textures its materials
+	// requested may still be streaming.
+	void WaitFor(const Resource &resource);
+	void WaitFor(const Texture &texture);
+	size_t GetPendingLoadCount() const { return m_loadGraph.GetPendingCount() + m_textureCache.GetPendingCount(); }
+
+	// Looks the name up once, keep the handle for lookups every frame. Invalid if there is no such resource.
+	template<IsResource T>
+	Handle<T> GetHandle(const std::string &name) const noexcept
+	{
+		std::shared_lock lock(m_mutex);
+		const SlotArray *slots = FindSlots<T>();
+		if (!slots)
 		{
-			throw std::runtime_error("No resources of type " + std::string(typeid(T).name()));
+			return {};
 		}
 
-		auto &resourceMap = mapIt->second;
-		auto resourceIt = resourceMap.find(name);
+		auto it = slots->byName.find(name);
+		if (it == slots->byName.end())
+		{
+			return {};
+		}
+		return Handle<T>(it->second, slots->slots[it->second].generation);
+	}
 
-		if (resourceIt == resourceMap.end())
+	// nullptr for invalid handles and resources removed since the handle was made
+	template<IsResource T>
+	std::shared_ptr<T> Get(Handle<T> handle) const noexcept
+	{
+		std::shared_lock lock(m_mutex);
+		const SlotArray *slots = FindSlots<T>();
+		if (!slots || handle.m_index >= slots->slots.size())
 		{
-			throw std::runtime_error("Resource '" + name + "' not found!");
+			return nullptr;
 		}
 
-		return std::static_pointer_cast<T>(resourceIt->second);
+		const Slot &slot = slots->slots[handle.m_index];
+		if (slot.generation != handle.m_generation)
+		{
+			return nullptr;
+		}
+		return std::static_pointer_cast<T>(slot.resource);
 	}
 
 	template<IsResource T>
-	std::shared_ptr<T> TryLoad(const std::string &name) noexcept
+	std::shared_ptr<T> Load(const std::string &name)
 	{
-		try
+		std::shared_lock lock(m_mutex);
+		const SlotArray *slots = FindSlots<T>();
+
+		if (!slots)
 		{
-			return Load<T>(name);
+			throw std::runtime_error("No resources of type " + std::string(typeid(T).name()));
 		}
-		catch (...)
+
+		auto it = slots->byName.find(name);
+
+		if (it == slots->byName.end())
 		{
-			return nullptr;
+			throw std::runtime_error("Resource '" + name + "' not found!");
 		}
+
+		return std::static_pointer_cast<T>(slots->slots[it->second].resource);
+	}
+
+	template<IsResource T>
+	std::shared_ptr<T> TryLoad(const std::string &name) noexcept
+	{
+		return Get(GetHandle<T>(name));
 	}
 
 	template<IsResource T>
 	bool Exists(const std::string &name) const noexcept
 	{
-		auto typeIndex = std::type_index(typeid(T));
-		auto mapIt = m_resources.find(typeIndex);
+		return GetHandle<T>(name).IsValid();
+	}
 
-		if (mapIt == m_resources.end())
+	template<IsResource T>
+	bool Remove(const std::string &name) noexcept
+	{
+		std::unique_lock lock(m_mutex);
+		SlotArray *slots = FindSlots<T>();
+		if (!slots)
 		{
 			return false;
 		}
 
-		return mapIt->second.find(name) != mapIt->second.end();
+		auto it = slots->byName.find(name);
+		if (it == slots->byName.end())
+		{
+			return false;
+		}
+		FreeSlot(*slots, it->second);
+		return true;
 	}
 
 	template<IsResource T>
-	bool Remove(const std::string &name) noexcept
+	bool Remove(Handle<T> handle) noexcept
 	{
-		auto typeIndex = std::type_index(typeid(T));
-		auto mapIt = m_resources.find(typeIndex);
-
-		if (mapIt != m_resources.end())
+		std::unique_lock lock(m_mutex);
+		SlotArray *slots = FindSlots<T>();
+		if (!slots || handle.m_index >= slots->slots.size() || slots->slots[handle.m_index].generation != handle.m_generation)
 		{
-			return mapIt->second.erase(name) > 0;
+			return false;
 		}
-		return false;
+		FreeSlot(*slots, handle.m_index);
+		return true;
 	}
 
 	template<IsResource T>
 	void ClearType() noexcept
 	{
-		auto typeIndex = std::type_index(typeid(T));
-		m_resources.erase(typeIndex);
+		std::unique_lock lock(m_mutex);
+		if (SlotArray *slots = FindSlots<T>())
+		{
+			ClearSlots(*slots);
+		}
 	}
 
+	// GL thread only, clears the caches as well
 	void ClearAll() noexcept
 	{
-		m_resources.clear();
+		{
+			std::unique_lock lock(m_mutex);
+			for (auto &slots : m_types)
+			{
+				ClearSlots(slots);
+			}
+		}
+		m_materialLibraries.clear();
+		m_textureCache.Clear();
+		m_shaderCache.Clear();
 	}
 
+	// Texture files by path, shared between named resources and model materials
+	TextureCache &GetTextureCache() { return m_textureCache; }
+	// Programs by source, shared by every material using the default shader
+	ShaderCache &GetShaderCache() { return m_shaderCache; }
+
 private:
 	ResourceManager() = default;
 	~ResourceManager() = default;
@@ -121,8 +251,68 @@ private:
 	ResourceManager(const ResourceManager &) = delete;
 	ResourceManager &operator=(const ResourceManager &) = delete;
 
-	std::unordered_map<
-		std::type_index,
-		std::unordered_map<std::string, std::shared_ptr<Resource>>
-	> m_resources;
-};
\ No newline at end of file
+	struct Slot
+	{
+		std::shared_ptr<Resource> resource;
+		std::string name;
+		uint32_t generation = 1;
+	};
+
+	struct SlotArray
+	{
+		std::vector<Slot> slots;
+		std::vector<uint32_t> freeSlots;
+		std::unordered_map<std::string, uint32_t> byName;
+	};
+
+	// Dense index of T into m_types, assigned on first use
+	template<typename T>
+	static size_t GetTypeIndex()
+	{
+		static const size_t index = s_typeCount++;
+		return index;
+	}
+
+	template<typename T>
+	const SlotArray *FindSlots() const
+	{
+		size_t type = GetTypeIndex<T>();
+		return type < m_types.size() ? &m_types[type] : nullptr;
+	}
+
+	template<typename T>
+	SlotArray *FindSlots()
+	{
+		size_t type = GetTypeIndex<T>();
+		return type < m_types.size() ? &m_types[type] : nullptr;
+	}
+
+	// Bumps the generation so handles to the old resource stop resolving, the caller holds the lock
+	static void FreeSlot(SlotArray &slots, uint32_t index);
+	static void ClearSlots(SlotArray &slots);
+
+	// Decodes into a reserved cache texture, the node's parent is whatever GL stage is running
+	LoadGraph::NodeId AddTextureNode(const std::shared_ptr<Texture> &texture, const std::string &path, bool generateMipMaps,
+		Texture::Residency residency);
+	std::vector<std::shared_ptr<Material>> CreateMaterials(const std::vector<MaterialData> &materials);
+	void LogLoadReport();
+
+	static inline std::atomic<size_t> s_typeCount = 0;
+
+	mutable std::shared_mutex m_mutex;
+	std::vector<SlotArray> m_types;
+
+	TextureCache m_textureCache;
+	ShaderCache m_shaderCache;
+	// By normalized path, GL thread only
+	std::unordered_map<std::string, std::vector<std::shared_ptr<Material>>> m_materialLibraries;
+
+	LoadGraph m_loadGraph;
+	// Placeholders and the nodes filling them, GL thread only
+	std::unordered_map<const Resource *, LoadGraph::NodeId> m_loading;
+};
+
+template<>
+std::shared_ptr<Texture> ResourceManager::LoadAsync<Texture>(const std::string &name, const std::string &path);
+template<>
+std::shared_ptr<Model> ResourceManager::LoadAsync<Model>(const std::string &name, const std::string &path);
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <glad/gl.h>
+#include <cstddef>
+#include <deque>
+
+// Streams texture data through one GL_PIXEL_UNPACK_BUFFER used as a ring. Pixels are copied into an unsynchronized
+// mapping and the driver copies them into the texture asynchronously; a fence per upload tells when its range can be
+// written again. Only uploads that find the ring full wait, and only for the oldest ranges; if that wait times out or
+// fails the upload goes through client memory instead.
+class TextureUploadRing
+{
+public:
+	static constexpr size_t kRingSize = 32 * 1024 * 1024;
+
+	// Same as glTexImage2D with client memory, size is the byte size of pixels
+	static void TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+		GLenum format, GLenum type, const void *pixels, size_t size);
+	// Same as glCompressedTexImage2D with client memory
+	static void CompressedTexImage2D(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height,
+		const void *data, size_t size);
+	// Same as glTexSubImage2D/glTexSubImage3D at offset 0, for immutable storage
+	static void TexSubImage2D(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type,
+		const void *pixels, size_t size);
+	static void CompressedTexSubImage2D(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format,
+		const void *data, size_t size);
+	static void TexSubImage3D(GLenum target, GLint level, GLsizei width, GLsizei height, GLsizei depth, GLenum format,
+		GLenum type, const void *pixels, size_t size);
+	static void CompressedTexSubImage3D(GLenum target, GLint level, GLsizei width, GLsizei height, GLsizei depth,
+		GLenum format, const void *data, size_t size);
+
+	// Releases the buffer and fences, must run while the context is still current
+	static void Shutdown();
+
+private:
+	struct Range
+	{
+		size_t offset;
+		size_t size;
+		GLsync fence;
+	};
+
+	// Copies data into the ring and leaves the buffer bound, returns false if the caller has to upload from client memory
+	static bool Stage(const void *data, size_t size, size_t &offset);
+	// Marks the staged range as in use by the upload just issued and unbinds the buffer
+	static void Submit(size_t offset, size_t size);
+	// Finds a free range, false if the oldest upload did not finish in time
+	static bool Allocate(size_t size, size_t &offset);
+	static void RetireSignaled();
+	// Waits up to a second for the oldest range and frees it, false on timeout or a failed wait
+	static bool WaitOldest();
+
+	static GLuint s_buffer;
+	static size_t s_head;
+	static std::deque<Range> s_inFlight;
+};
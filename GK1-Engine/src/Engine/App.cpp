@@ -1,5 +1,10 @@
 #include "Engine/App.h"
 #include "Engine/Log.h"
+#include "Engine/NullGL.h"
+#include "Engine/Profiler.h"
+#include "Engine/GpuProfiler.h"
+#include "Engine/RenderStats.h"
+#include "Engine/TextureUploadRing.h"
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -10,9 +15,13 @@
 #include "Engine/Input.h"
 #include "Engine/Loader/LoaderManager.h"
 
-App::App(std::string title, int width, int height)
+App::App(std::string title, int width, int height, HeadlessMode headless)
+	: m_Headless(headless)
 {
-	Initialize();
+	Profiler::SetThreadName("Main");
+	PROFILE_SCOPE("App::Initialize");
+
+	Initialize(headless);
 
 	Log::Info("Creating window");
 	m_Window = new Window(width, height, title);
@@ -27,11 +36,22 @@ App::App(std::string title, int width, int height)
 			app->OnResize(width, height);
 		});
 
-	glfwMakeContextCurrent(m_Window->GetHandle());
-	glfwSwapInterval(m_IsVsync);
-
-	if (!gladLoadGL(glfwGetProcAddress))
-		throw std::runtime_error("Failed to initialize GLAD");
+	if (headless == HeadlessMode::Null)
+	{
+		if (!NullGL::Load())
+			throw std::runtime_error("Failed to initialize NullGL");
+	}
+	else
+	{
+		glfwMakeContextCurrent(m_Window->GetHandle());
+		glfwSwapInterval(m_IsVsync);
+
+		if (!gladLoadGL(glfwGetProcAddress))
+			throw std::runtime_error("Failed to initialize GLAD");
+		// Cubemaps use immutable storage, a 4.1 context would call glTexStorage through a null pointer
+		if (!GLAD_GL_VERSION_4_2)
+			throw std::runtime_error("OpenGL 4.2 is required");
+	}
 
 	Log::Info("Initializing renderer");
 	m_Renderer = new Renderer(m_Window);
@@ -49,10 +69,16 @@ App::App(std::string title, int width, int height)
 
 App::~App()
 {
+	// Query objects and the upload buffer belong to the context owned by the window
+	GpuProfiler::Shutdown();
+	TextureUploadRing::Shutdown();
 	delete m_Window;
 	delete m_Renderer;
-	ImGui_ImplOpenGL3_Shutdown();
-	ImGui_ImplGlfw_Shutdown();
+	// Backends are only initialized by Run(), headless benchmarks drive the frame themselves
+	if (ImGui::GetIO().BackendRendererUserData)
+		ImGui_ImplOpenGL3_Shutdown();
+	if (ImGui::GetIO().BackendPlatformUserData)
+		ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
 	Log::Shutdown();
 }
@@ -61,10 +87,18 @@ void App::Run()
 {
 	ImGuiIO &io = ImGui::GetIO(); (void)io;
 
-	OnLoad(m_ResourceManager);
+	double startTime = glfwGetTime();
+	{
+		PROFILE_SCOPE("App::OnLoad");
+		OnLoad(m_ResourceManager);
+	}
 
-	OnStart();
+	{
+		PROFILE_SCOPE("App::OnStart");
+		OnStart();
+	}
 
+	// Async loads keep streaming in over the first frames, placeholders are drawn until they arrive
 	ImGuiStyle &style = ImGui::GetStyle();
 	if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 	{
@@ -76,17 +110,26 @@ void App::Run()
 	ImGui_ImplGlfw_InitForOpenGL(m_Window->GetHandle(), true);
 	ImGui_ImplOpenGL3_Init("#version 330 core");
 
+	Profiler::EndStartup();
+
 	float currentTime = static_cast<float>(glfwGetTime());
+	bool firstFrame = true;
 
 	while (!glfwWindowShouldClose(m_Window->GetHandle()))
 	{
+		PROFILE_SCOPE("App::Frame");
+
 		float newTime = static_cast<float>(glfwGetTime());
 		float deltaTime = newTime - currentTime;
 		currentTime = newTime;
 
 		Input::Update();
+		m_ResourceManager->ProcessLoads();
 		deltaTime = std::min(deltaTime, 1.0f/30.0f);
-		OnUpdate(deltaTime);
+		{
+			PROFILE_SCOPE("App::OnUpdate");
+			OnUpdate(deltaTime);
+		}
 
 		glfwPollEvents();
 		if (glfwGetWindowAttrib(m_Window->GetHandle(), GLFW_ICONIFIED) != 0)
@@ -96,28 +139,55 @@ void App::Run()
 		}
 
 		// Start the Dear ImGui frame
-		ImGui_ImplOpenGL3_NewFrame();
-		ImGui_ImplGlfw_NewFrame();
-		ImGui::NewFrame();
-		OnImGuiRender();
-		ImGui::Render();
+		{
+			PROFILE_SCOPE("ImGui::NewFrame");
+			ImGui_ImplOpenGL3_NewFrame();
+			ImGui_ImplGlfw_NewFrame();
+			ImGui::NewFrame();
+			OnImGuiRender();
+			ImGui::Render();
+		}
 
 		int display_w, display_h;
 		glfwGetFramebufferSize(m_Window->GetHandle(), &display_w, &display_h);
 		glViewport(0, 0, display_w, display_h);
 
-		OnRender(m_Renderer);
+		GpuProfiler::BeginFrame();
+		{
+			PROFILE_SCOPE("App::OnRender");
+			OnRender(m_Renderer);
+		}
 
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
-			GLFWwindow *backup_current_context = glfwGetCurrentContext();
-			ImGui::UpdatePlatformWindows();
-			ImGui::RenderPlatformWindowsDefault();
-			glfwMakeContextCurrent(backup_current_context);
+			PROFILE_SCOPE("ImGui::RenderDrawData");
+			{
+				GPU_PROFILE_SCOPE("ImGui");
+				ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			}
+			GpuProfiler::EndFrame();
+			RenderStats::EndFrame();
+
+			// Platform windows render into other contexts, query objects are not shared with them
+			if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+			{
+				GLFWwindow *backup_current_context = glfwGetCurrentContext();
+				ImGui::UpdatePlatformWindows();
+				ImGui::RenderPlatformWindowsDefault();
+				glfwMakeContextCurrent(backup_current_context);
+			}
 		}
 
-		glfwSwapBuffers(m_Window->GetHandle());
+		{
+			PROFILE_SCOPE("glfwSwapBuffers");
+			glfwSwapBuffers(m_Window->GetHandle());
+		}
+
+		if (firstFrame)
+		{
+			firstFrame = false;
+			Log::Info("First frame after " + std::to_string(static_cast<int>((glfwGetTime() - startTime) * 1000.0)) + " ms, "
+				+ std::to_string(m_ResourceManager->GetPendingLoadCount()) + " loads still streaming");
+		}
 
 #ifdef _DEBUG
 		FPSCounter(deltaTime);
@@ -133,7 +203,8 @@ void App::Close()
 void App::SetVSync(bool enabled)
 {
 	m_IsVsync = enabled;
-	glfwSwapInterval(enabled);
+	if (m_Headless != HeadlessMode::Null)
+		glfwSwapInterval(enabled);
 }
 
 glm::ivec2 App::GetViewport() const
@@ -143,17 +214,32 @@ glm::ivec2 App::GetViewport() const
 	return glm::ivec2(width, height);
 }
 
-void App::Initialize()
+void App::Initialize(HeadlessMode headless)
 {
 	Log::Init();
 
+	// The null platform needs no display server, the context comes from EGL or OSMesa (e.g. llvmpipe)
+	if (headless != HeadlessMode::None)
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+
 	if (!glfwInit())
 		throw std::runtime_error("Failed to initialize GLFW");
 
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+	if (headless == HeadlessMode::Null)
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+	}
+	else if (headless != HeadlessMode::None)
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, headless == HeadlessMode::EGL ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API);
+	}
+
 	LoaderManager::Initialize();
 }
 
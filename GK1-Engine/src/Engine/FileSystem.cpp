@@ -0,0 +1,156 @@
+#include "Engine/FileSystem.h"
+#include "Engine/LZ4.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+
+std::shared_mutex FileSystem::s_mutex;
+std::vector<std::shared_ptr<const PackFile>> FileSystem::s_packs;
+std::atomic<uint64_t> FileSystem::s_packReads = 0;
+std::atomic<uint64_t> FileSystem::s_diskReads = 0;
+
+bool FileSystem::Mount(const std::string &packPath)
+{
+	auto pack = std::make_shared<PackFile>();
+	if (!pack->Open(packPath))
+		return false;
+
+	std::unique_lock lock(s_mutex);
+	s_packs.push_back(std::move(pack));
+	return true;
+}
+
+void FileSystem::UnmountAll()
+{
+	std::unique_lock lock(s_mutex);
+	s_packs.clear();
+}
+
+size_t FileSystem::GetMountedEntryCount()
+{
+	std::shared_lock lock(s_mutex);
+	size_t count = 0;
+	for (const auto &pack : s_packs)
+		count += pack->GetEntryCount();
+	return count;
+}
+
+std::shared_ptr<const PackFile> FileSystem::FindEntry(const std::string &path, const PackFile::Entry *&entry)
+{
+	std::shared_lock lock(s_mutex);
+	if (s_packs.empty())
+		return nullptr;
+
+	std::string key = Normalize(path);
+	for (auto it = s_packs.rbegin(); it != s_packs.rend(); ++it)
+	{
+		entry = (*it)->Find(key);
+		if (entry)
+			return *it;
+	}
+	return nullptr;
+}
+
+bool FileSystem::Read(const std::string &path, FileData &file)
+{
+	file = FileData();
+
+	const PackFile::Entry *entry = nullptr;
+	if (auto pack = FindEntry(path, entry))
+	{
+		std::string_view stored = pack->GetStoredData(*entry);
+		if (entry->compression == PackFile::Compression::None)
+		{
+			// Zero-copy, the span keeps the pack mapped
+			file.m_view = stored;
+			file.m_pack = std::move(pack);
+		}
+		else if (entry->compression == PackFile::Compression::LZ4)
+		{
+			file.m_buffer = std::make_unique<char[]>(entry->size);
+			if (!LZ4::Decompress(stored.data(), stored.size(), file.m_buffer.get(), entry->size))
+			{
+				std::cerr << "Corrupt entry " << path << " in pack " << pack->GetPath() << std::endl;
+				file = FileData();
+				return false;
+			}
+			file.m_view = std::string_view(file.m_buffer.get(), entry->size);
+		}
+		else
+		{
+			std::cerr << "Unknown compression of " << path << " in pack " << pack->GetPath() << std::endl;
+			return false;
+		}
+		s_packReads++;
+		return true;
+	}
+
+	if (!file.m_file.Open(path))
+		return false;
+	file.m_view = file.m_file.GetView();
+	s_diskReads++;
+	return true;
+}
+
+bool FileSystem::GetInfo(const std::string &path, Info &info)
+{
+	const PackFile::Entry *entry = nullptr;
+	if (FindEntry(path, entry))
+	{
+		info.size = entry->size;
+		info.time = entry->time;
+		return true;
+	}
+
+	std::error_code error;
+	auto size = std::filesystem::file_size(path, error);
+	if (error) return false;
+	auto time = std::filesystem::last_write_time(path, error);
+	if (error) return false;
+
+	info.size = size;
+	info.time = time.time_since_epoch().count();
+	return true;
+}
+
+bool FileSystem::Exists(const std::string &path)
+{
+	const PackFile::Entry *entry = nullptr;
+	if (FindEntry(path, entry))
+		return true;
+
+	std::error_code error;
+	return std::filesystem::is_regular_file(path, error);
+}
+
+bool FileSystem::IsPacked(const std::string &path)
+{
+	const PackFile::Entry *entry = nullptr;
+	return FindEntry(path, entry) != nullptr;
+}
+
+std::string FileSystem::Normalize(const std::string &path)
+{
+	static const std::filesystem::path workingDirectory = std::filesystem::current_path();
+
+	std::string generic = path;
+	std::replace(generic.begin(), generic.end(), '\\', '/');
+
+	std::filesystem::path normalized = std::filesystem::path(generic).lexically_normal();
+	if (normalized.is_absolute())
+		normalized = normalized.lexically_proximate(workingDirectory);
+
+	std::string key = normalized.generic_string();
+	if (key.rfind("./", 0) == 0)
+		key.erase(0, 2);
+	std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return key;
+}
+
+FileSystem::Stats FileSystem::GetStats()
+{
+	return Stats{ s_packReads.load(), s_diskReads.load() };
+}
@@ -1,11 +1,33 @@
 #include "Engine/Geometry.h"
+#include "Engine/Resource/GpuMemory.h"
+#include "Engine/JobSystem.h"
+#include "Engine/Profiler.h"
+#include "Engine/RenderStats.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
-Geometry::Geometry() : m_vao(0), m_vbo(0), m_ebo(0), m_vertexCount(0), m_indexCount(0)
+namespace
 {
+	// Triangles or vertices per job, smaller meshes are processed on the calling thread
+	constexpr size_t kTangentBatchSize = 16384;
+
+	template<typename F>
+	void ForEachBatch(size_t count, F &&body)
+	{
+		size_t batches = (count + kTangentBatchSize - 1) / kTangentBatchSize;
+		JobSystem::Get().ParallelFor(batches, [count, &body](size_t batch)
+			{
+				body(batch * kTangentBatchSize, std::min(count, (batch + 1) * kTangentBatchSize));
+			});
+	}
 }
 
-Geometry::Geometry(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) : Geometry()
+Geometry::Geometry() : m_vao(0), m_vbo(0), m_ebo(0), m_vertexCount(0), m_indexCount(0), m_evicted(false)
+{
+}
+
+Geometry::Geometry(std::span<const Vertex> vertices, std::span<const uint32_t> indices) : Geometry()
 {
 	SetData(vertices, indices);
 }
@@ -34,12 +56,13 @@ void Geometry::Cleanup()
 	}
 }
 
-void Geometry::SetData(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
+void Geometry::SetData(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
 {
 	Cleanup();
+	m_evicted = false;
 
-	m_vertices = vertices;
-	m_indices = indices;
+	m_vertices.assign(vertices.begin(), vertices.end());
+	m_indices.assign(indices.begin(), indices.end());
 	m_vertexCount = vertices.size();
 	m_indexCount = indices.size();
 
@@ -64,6 +87,7 @@ void Geometry::SetupGeometry()
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(uint32_t),
 				 m_indices.data(), GL_STATIC_DRAW);
+	RenderStats::AddBufferUpload(m_vertices.size() * sizeof(Vertex) + m_indices.size() * sizeof(uint32_t));
 
 	// Set vertex attribute pointers
 	// Position
@@ -92,4 +116,114 @@ void Geometry::SetupGeometry()
 						  (void *)offsetof(Vertex, bitangent));
 
 	glBindVertexArray(0);
-}
\ No newline at end of file
+}
+
+void Geometry::Bind()
+{
+	MarkUsed();
+	if (m_evicted)
+	{
+		// The vertices never left memory, a restore is a plain buffer upload
+		m_evicted = false;
+		SetupGeometry();
+		GpuMemory::AddRestore();
+	}
+	glBindVertexArray(m_vao);
+}
+
+size_t Geometry::GetGpuBytes() const
+{
+	if (m_vao == 0)
+		return 0;
+	return m_vertices.size() * sizeof(Vertex) + m_indices.size() * sizeof(uint32_t);
+}
+
+bool Geometry::Evict()
+{
+	if (m_vao == 0)
+		return false;
+
+	Cleanup();
+	m_evicted = true;
+	return true;
+}
+
+void Geometry::CalculateTangents(std::span<Vertex> vertices, std::span<const uint32_t> indices)
+{
+	PROFILE_SCOPE("Geometry::CalculateTangents");
+
+	// Reused between calls so importing many meshes does not allocate per mesh
+	struct Scratch
+	{
+		std::vector<glm::vec3> tangents;
+		std::vector<glm::vec3> bitangents;
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+	};
+	thread_local Scratch threadScratch;
+	// Jobs run on other threads and must see the caller's buffers, not their own thread_local instance
+	Scratch &scratch = threadScratch;
+
+	size_t triangleCount = indices.size() / 3;
+	scratch.tangents.resize(triangleCount);
+	scratch.bitangents.resize(triangleCount);
+
+	ForEachBatch(triangleCount, [&scratch, &vertices, &indices](size_t begin, size_t end)
+		{
+			for (size_t t = begin; t < end; t++)
+			{
+				const Vertex &v0 = vertices[indices[t * 3]];
+				const Vertex &v1 = vertices[indices[t * 3 + 1]];
+				const Vertex &v2 = vertices[indices[t * 3 + 2]];
+
+				glm::vec3 edge1 = v1.position - v0.position;
+				glm::vec3 edge2 = v2.position - v0.position;
+				glm::vec2 deltaUV1 = v1.texCoords - v0.texCoords;
+				glm::vec2 deltaUV2 = v2.texCoords - v0.texCoords;
+
+				float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
+				if (std::isinf(f)) f = 1.0f;
+				scratch.tangents[t] = f * (deltaUV2.y * edge1 - deltaUV1.y * edge2);
+				scratch.bitangents[t] = f * (deltaUV1.x * edge2 - deltaUV2.x * edge1);
+			}
+		});
+
+	// Triangles around each vertex in index order (counting sort). Vertices gather instead of triangles scattering,
+	// so sums are formed in the same order on any number of threads.
+	scratch.offsets.assign(vertices.size() + 2, 0);
+	for (uint32_t index : indices.first(triangleCount * 3))
+		scratch.offsets[index + 2]++;
+	for (size_t v = 2; v < scratch.offsets.size(); v++)
+		scratch.offsets[v] += scratch.offsets[v - 1];
+
+	scratch.triangles.resize(triangleCount * 3);
+	for (size_t corner = 0; corner < triangleCount * 3; corner++)
+		scratch.triangles[scratch.offsets[indices[corner] + 1]++] = static_cast<uint32_t>(corner / 3);
+
+	// offsets[v]..offsets[v + 1] now spans the triangles of vertex v
+	ForEachBatch(vertices.size(), [&scratch, &vertices](size_t begin, size_t end)
+		{
+			for (size_t v = begin; v < end; v++)
+			{
+				uint32_t first = scratch.offsets[v];
+				uint32_t last = scratch.offsets[v + 1];
+
+				glm::vec3 tangent(0.0f);
+				glm::vec3 bitangent(0.0f);
+				for (uint32_t i = first; i < last; i++)
+				{
+					tangent += scratch.tangents[scratch.triangles[i]];
+					bitangent += scratch.bitangents[scratch.triangles[i]];
+				}
+
+				if (last > first)
+				{
+					float count = static_cast<float>(last - first);
+					tangent = glm::normalize(tangent / count);
+					bitangent = glm::normalize(bitangent / count);
+				}
+				vertices[v].tangent = tangent;
+				vertices[v].bitangent = bitangent;
+			}
+		});
+}
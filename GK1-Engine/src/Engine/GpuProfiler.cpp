@@ -0,0 +1,130 @@
+#include "Engine/GpuProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+GpuProfiler::FrameQueries GpuProfiler::s_frames[kFrameLatency];
+int GpuProfiler::s_currentFrame = 0;
+std::vector<size_t> GpuProfiler::s_stack;
+std::vector<GpuProfiler::Result> GpuProfiler::s_results;
+uint64_t GpuProfiler::s_resolvedFrames = 0;
+
+void GpuProfiler::BeginFrame()
+{
+	s_currentFrame = (s_currentFrame + 1) % kFrameLatency;
+
+	// This slot was filled kFrameLatency frames ago
+	FrameQueries &frame = s_frames[s_currentFrame];
+	if (frame.pending)
+	{
+		Resolve(frame);
+	}
+
+	frame.segments.clear();
+	frame.occurrences.clear();
+	frame.pending = false;
+	s_stack.clear();
+}
+
+void GpuProfiler::EndFrame()
+{
+	// Close zones left open by an early return
+	while (!s_stack.empty())
+	{
+		EndZone();
+	}
+	s_frames[s_currentFrame].pending = !s_frames[s_currentFrame].segments.empty();
+}
+
+void GpuProfiler::BeginZone(const char *name)
+{
+	FrameQueries &frame = s_frames[s_currentFrame];
+
+	if (!s_stack.empty())
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+
+	frame.occurrences.push_back({ name, Profiler::Now() });
+	s_stack.push_back(frame.occurrences.size() - 1);
+	BeginSegment();
+}
+
+void GpuProfiler::EndZone()
+{
+	if (s_stack.empty()) return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	s_stack.pop_back();
+
+	if (!s_stack.empty())
+	{
+		BeginSegment();
+	}
+}
+
+void GpuProfiler::Shutdown()
+{
+	for (auto &frame : s_frames)
+	{
+		if (!frame.pool.empty())
+		{
+			glDeleteQueries(static_cast<GLsizei>(frame.pool.size()), frame.pool.data());
+		}
+		frame = FrameQueries();
+	}
+	s_stack.clear();
+	s_results.clear();
+}
+
+void GpuProfiler::BeginSegment()
+{
+	FrameQueries &frame = s_frames[s_currentFrame];
+
+	size_t index = frame.segments.size();
+	if (index == frame.pool.size())
+	{
+		GLuint query;
+		glGenQueries(1, &query);
+		frame.pool.push_back(query);
+	}
+
+	frame.segments.push_back({ s_stack.back(), frame.pool[index] });
+	glBeginQuery(GL_TIME_ELAPSED, frame.pool[index]);
+}
+
+void GpuProfiler::Resolve(FrameQueries &frame)
+{
+	// Queries complete in order, if the last one is not ready yet drop the frame instead of waiting
+	GLint available = 0;
+	glGetQueryObjectiv(frame.segments.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available) return;
+
+	std::vector<uint64_t> durations(frame.occurrences.size(), 0);
+	for (const auto &segment : frame.segments)
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(segment.query, GL_QUERY_RESULT, &elapsed);
+		durations[segment.occurrence] += elapsed;
+	}
+
+	s_results.clear();
+	s_resolvedFrames++;
+	for (size_t i = 0; i < frame.occurrences.size(); i++)
+	{
+		const Occurrence &occurrence = frame.occurrences[i];
+		Profiler::RecordGpu(occurrence.name, occurrence.cpuStart, static_cast<int64_t>(durations[i]));
+
+		auto it = std::find_if(s_results.begin(), s_results.end(),
+			[&occurrence](const Result &result)
+			{
+				return std::strcmp(result.name, occurrence.name) == 0;
+			});
+
+		double milliseconds = durations[i] / 1e6;
+		if (it != s_results.end())
+			it->milliseconds += milliseconds;
+		else
+			s_results.push_back({ occurrence.name, milliseconds });
+	}
+}
@@ -4,7 +4,10 @@
 #define IMGUI_IMPL_OPENGL_LOADER_CUSTOM
 #define IMGUI_IMPL_OPENGL_LOADER_GLFW_GLAD
 #include "Engine/ImGUI_Impl.h"
+#include "Engine/Resource/ProgramBinaryCache.h"
+#include "Engine/Resource/ShaderCache.h"
 #include <glad/gl.h>
+#include <string>
 
 #pragma region GLFW
 
@@ -2362,32 +2365,43 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
         fragment_shader = fragment_shader_glsl_130;
     }
 
-    // Create shaders
-    const GLchar* vertex_shader_with_version[2] = { bd->GlslVersionString, vertex_shader };
-    GLuint vert_handle;
-    GL_CALL(vert_handle = glCreateShader(GL_VERTEX_SHADER));
-    glShaderSource(vert_handle, 2, vertex_shader_with_version, nullptr);
-    glCompileShader(vert_handle);
-    CheckShader(vert_handle, "vertex shader");
-
-    const GLchar* fragment_shader_with_version[2] = { bd->GlslVersionString, fragment_shader };
-    GLuint frag_handle;
-    GL_CALL(frag_handle = glCreateShader(GL_FRAGMENT_SHADER));
-    glShaderSource(frag_handle, 2, fragment_shader_with_version, nullptr);
-    glCompileShader(frag_handle);
-    CheckShader(frag_handle, "fragment shader");
-
-    // Link
+    // Reuse the program binary of an earlier run, compile only when there is none
+    const std::string vertex_source = std::string(bd->GlslVersionString) + vertex_shader;
+    const std::string fragment_source = std::string(bd->GlslVersionString) + fragment_shader;
+    const ShaderCache::Stage stages[] = { { Shader::ShaderType::Vertex, vertex_source }, { Shader::ShaderType::Fragment, fragment_source } };
+    const uint64_t source_hash = ShaderCache::Hash(stages);
+
     bd->ShaderHandle = glCreateProgram();
-    glAttachShader(bd->ShaderHandle, vert_handle);
-    glAttachShader(bd->ShaderHandle, frag_handle);
-    glLinkProgram(bd->ShaderHandle);
-    CheckProgram(bd->ShaderHandle, "shader program");
-
-    glDetachShader(bd->ShaderHandle, vert_handle);
-    glDetachShader(bd->ShaderHandle, frag_handle);
-    glDeleteShader(vert_handle);
-    glDeleteShader(frag_handle);
+    if (!ProgramBinaryCache::Load(bd->ShaderHandle, source_hash))
+    {
+        // Create shaders
+        const GLchar* vertex_shader_with_version[2] = { bd->GlslVersionString, vertex_shader };
+        GLuint vert_handle;
+        GL_CALL(vert_handle = glCreateShader(GL_VERTEX_SHADER));
+        glShaderSource(vert_handle, 2, vertex_shader_with_version, nullptr);
+        glCompileShader(vert_handle);
+        CheckShader(vert_handle, "vertex shader");
+
+        const GLchar* fragment_shader_with_version[2] = { bd->GlslVersionString, fragment_shader };
+        GLuint frag_handle;
+        GL_CALL(frag_handle = glCreateShader(GL_FRAGMENT_SHADER));
+        glShaderSource(frag_handle, 2, fragment_shader_with_version, nullptr);
+        glCompileShader(frag_handle);
+        CheckShader(frag_handle, "fragment shader");
+
+        // Link
+        glAttachShader(bd->ShaderHandle, vert_handle);
+        glAttachShader(bd->ShaderHandle, frag_handle);
+        ProgramBinaryCache::PrepareLink(bd->ShaderHandle);
+        glLinkProgram(bd->ShaderHandle);
+        if (CheckProgram(bd->ShaderHandle, "shader program"))
+            ProgramBinaryCache::Store(bd->ShaderHandle, source_hash);
+
+        glDetachShader(bd->ShaderHandle, vert_handle);
+        glDetachShader(bd->ShaderHandle, frag_handle);
+        glDeleteShader(vert_handle);
+        glDeleteShader(frag_handle);
+    }
 
     bd->AttribLocationTex = glGetUniformLocation(bd->ShaderHandle, "Texture");
     bd->AttribLocationProjMtx = glGetUniformLocation(bd->ShaderHandle, "ProjMtx");
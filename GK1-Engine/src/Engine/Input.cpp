@@ -1,4 +1,5 @@
 #include "Engine/Input.h"
+#include "Engine/Profiler.h"
 
 std::unordered_map<int, bool> Input::currentKeyState;
 std::unordered_map<int, bool> Input::previousKeyState;
@@ -24,6 +25,8 @@ void Input::Init(GLFWwindow* windowHandle)
 }
 
 void Input::Update() {
+	PROFILE_SCOPE("Input::Update");
+
 	previousKeyState = currentKeyState;
 	for (const auto& [key, _] : previousKeyState) {
 		currentKeyState[key] = glfwGetKey(window, key) == GLFW_PRESS;
@@ -0,0 +1,100 @@
+#include "Engine/JobSystem.h"
+#include "Engine/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+JobSystem::JobSystem()
+{
+	// Leave one core to the main thread, which also takes part in ParallelFor
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	size_t workerCount = std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+
+	m_workers.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; i++)
+		m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_condition.notify_all();
+
+	for (auto &worker : m_workers)
+		worker.join();
+}
+
+void JobSystem::Enqueue(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.push_back(std::move(job));
+	}
+	m_condition.notify_one();
+}
+
+void JobSystem::WorkerLoop(size_t index)
+{
+	Profiler::SetThreadName("Worker " + std::to_string(index));
+
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+			if (m_stopping && m_queue.empty())
+				return;
+
+			job = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+		job();
+	}
+}
+
+void JobSystem::ParallelFor(size_t count, const std::function<void(size_t)> &body)
+{
+	if (count == 0) return;
+	if (count == 1)
+	{
+		body(0);
+		return;
+	}
+
+	// Iterations are claimed from a shared counter, the state outlives helpers that start after the loop finished
+	struct State
+	{
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> done{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+	auto state = std::make_shared<State>();
+
+	auto run = [state, count, &body]()
+		{
+			for (size_t i = state->next++; i < count; i = state->next++)
+			{
+				body(i);
+				if (++state->done == count)
+				{
+					std::lock_guard<std::mutex> lock(state->mutex);
+					state->finished.notify_all();
+				}
+			}
+		};
+
+	size_t helpers = std::min(count - 1, m_workers.size());
+	for (size_t i = 0; i < helpers; i++)
+		Enqueue(run);
+
+	run();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->finished.wait(lock, [&state, count]() { return state->done == count; });
+}
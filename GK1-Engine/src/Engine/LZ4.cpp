@@ -0,0 +1,152 @@
+#include "Engine/LZ4.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	constexpr size_t kMinMatch = 4;
+	// The format requires the last match to start this far from the end and the last bytes to be literals
+	constexpr size_t kMatchStartLimit = 12;
+	constexpr size_t kLastLiterals = 5;
+	constexpr size_t kMaxOffset = 65535;
+	constexpr int kHashBits = 16;
+
+	uint32_t Read32(const char *data)
+	{
+		uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	uint32_t Hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - kHashBits);
+	}
+
+	// Lengths of 15 and more continue in bytes of 255 plus a remainder
+	void WriteLength(std::vector<char> &out, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			out.push_back(static_cast<char>(255));
+		out.push_back(static_cast<char>(length));
+	}
+
+	void WriteSequence(std::vector<char> &out, const char *literals, size_t literalLength, size_t offset, size_t matchLength)
+	{
+		size_t matchCode = matchLength >= kMinMatch ? matchLength - kMinMatch : 0;
+		uint8_t token = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4 | (matchCode < 15 ? matchCode : 15));
+		out.push_back(static_cast<char>(token));
+		if (literalLength >= 15)
+			WriteLength(out, literalLength - 15);
+		out.insert(out.end(), literals, literals + literalLength);
+
+		// The last sequence has literals only
+		if (matchLength == 0) return;
+		out.push_back(static_cast<char>(offset & 0xFF));
+		out.push_back(static_cast<char>(offset >> 8));
+		if (matchCode >= 15)
+			WriteLength(out, matchCode - 15);
+	}
+
+	bool ReadLength(const uint8_t *&in, const uint8_t *end, size_t &length)
+	{
+		uint8_t byte;
+		do
+		{
+			if (in == end) return false;
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+}
+
+std::vector<char> LZ4::Compress(const char *source, size_t size)
+{
+	std::vector<char> out;
+	out.reserve(size + size / 255 + 16);
+
+	size_t anchor = 0;
+	if (size > kMatchStartLimit)
+	{
+		// Last position each hashed 4-byte sequence was seen at, plus one so zero means empty
+		std::vector<uint32_t> table(size_t(1) << kHashBits, 0);
+		size_t limit = size - kMatchStartLimit;
+		size_t matchEndLimit = size - kLastLiterals;
+
+		size_t position = 0;
+		while (position < limit)
+		{
+			uint32_t sequence = Read32(source + position);
+			uint32_t &slot = table[Hash(sequence)];
+			size_t candidate = slot;
+			slot = static_cast<uint32_t>(position + 1);
+
+			if (candidate == 0 || position - (candidate - 1) > kMaxOffset || Read32(source + candidate - 1) != sequence)
+			{
+				position++;
+				continue;
+			}
+
+			size_t match = candidate - 1;
+			size_t length = kMinMatch;
+			while (position + length < matchEndLimit && source[match + length] == source[position + length])
+				length++;
+
+			WriteSequence(out, source + anchor, position - anchor, position - match, length);
+			position += length;
+			anchor = position;
+		}
+	}
+
+	WriteSequence(out, source + anchor, size - anchor, 0, 0);
+	return out;
+}
+
+bool LZ4::Decompress(const char *source, size_t sourceSize, char *destination, size_t size)
+{
+	const uint8_t *in = reinterpret_cast<const uint8_t *>(source);
+	const uint8_t *inEnd = in + sourceSize;
+	size_t written = 0;
+
+	while (in < inEnd)
+	{
+		uint8_t token = *in++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLength(in, inEnd, literalLength)) return false;
+		if (static_cast<size_t>(inEnd - in) < literalLength || size - written < literalLength) return false;
+		std::memcpy(destination + written, in, literalLength);
+		in += literalLength;
+		written += literalLength;
+
+		// Only the last sequence ends after its literals
+		if (in == inEnd) break;
+
+		if (inEnd - in < 2) return false;
+		size_t offset = in[0] | in[1] << 8;
+		in += 2;
+		if (offset == 0 || offset > written) return false;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLength(in, inEnd, matchLength)) return false;
+		matchLength += kMinMatch;
+		if (size - written < matchLength) return false;
+
+		// Matches may overlap their own output (runs), so copy forward byte by byte in that case
+		const char *match = destination + written - offset;
+		if (offset >= matchLength)
+		{
+			std::memcpy(destination + written, match, matchLength);
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; i++)
+				destination[written + i] = match[i];
+		}
+		written += matchLength;
+	}
+
+	return written == size;
+}
@@ -0,0 +1,331 @@
+#include "Engine/LoadGraph.h"
+#include "Engine/JobSystem.h"
+#include "Engine/Profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+	double ToMs(LoadGraph::Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+LoadGraph::NodeId LoadGraph::Add(const std::string &name, std::function<bool()> cpu, std::function<void()> gl,
+	const std::vector<NodeId> &dependencies)
+{
+	NodeId id = m_nodes.size();
+	for (NodeId dependency : dependencies)
+	{
+		if (dependency >= id)
+			throw std::runtime_error("Load graph node '" + name + "' depends on an unknown node");
+	}
+
+	// Deque elements stay put while GL stages add more nodes
+	Node &node = m_nodes.emplace_back();
+	node.name = name;
+	node.gl = std::move(gl);
+	node.parent = m_running;
+	node.added = Clock::now();
+
+	if (node.parent != kNoNode)
+	{
+		m_nodes[node.parent].children.push_back(id);
+		m_nodes[node.parent].openChildren++;
+	}
+
+	for (NodeId dependency : dependencies)
+	{
+		node.dependencies.push_back(dependency);
+		if (!m_nodes[dependency].finished)
+		{
+			m_nodes[dependency].dependents.push_back(id);
+			node.openDependencies++;
+		}
+	}
+
+	if (!cpu)
+	{
+		node.cpuDone = true;
+		MarkReady(id);
+		return id;
+	}
+
+	JobSystem::Get().Submit([queue = m_queue, id, cpu = std::move(cpu)]()
+		{
+			PROFILE_SCOPE("LoadGraph::Cpu");
+			auto start = Clock::now();
+			bool success = cpu();
+
+			std::lock_guard<std::mutex> lock(queue->mutex);
+			queue->results.push_back(CpuResult{ id, success, ToMs(Clock::now() - start) });
+			queue->ready.notify_one();
+		});
+	return id;
+}
+
+bool LoadGraph::Process()
+{
+	return Process(m_glBudgetMs);
+}
+
+bool LoadGraph::Process(double budgetMs)
+{
+	PROFILE_SCOPE("LoadGraph::Process");
+	CollectResults(false);
+
+	// Same rule as TextureCache::ProcessUploads: at least one stage per call, so a stage larger than the budget
+	// still runs
+	auto start = Clock::now();
+	bool ranAny = false;
+	while (!m_ready.empty() && (!ranAny || ToMs(Clock::now() - start) < budgetMs))
+	{
+		NodeId node = m_ready.front();
+		m_ready.pop_front();
+		RunGl(node);
+		ranAny = true;
+	}
+	return GetPendingCount() == 0;
+}
+
+void LoadGraph::Wait()
+{
+	PROFILE_SCOPE("LoadGraph::Wait");
+	// Every unfinished node is waiting on some CPU stage, directly or through dependencies and children
+	while (!Process(std::numeric_limits<double>::infinity()))
+		CollectResults(true);
+}
+
+void LoadGraph::WaitFor(NodeId node)
+{
+	PROFILE_SCOPE("LoadGraph::WaitFor");
+	while (node < m_nodes.size() && !m_nodes[node].finished)
+	{
+		Process(std::numeric_limits<double>::infinity());
+		if (!m_nodes[node].finished)
+			CollectResults(true);
+	}
+}
+
+void LoadGraph::WaitForGl(NodeId node)
+{
+	PROFILE_SCOPE("LoadGraph::WaitForGl");
+	while (node < m_nodes.size() && !m_nodes[node].glDone)
+	{
+		Process(std::numeric_limits<double>::infinity());
+		if (!m_nodes[node].glDone)
+			CollectResults(true);
+	}
+}
+
+void LoadGraph::CollectResults(bool wait)
+{
+	std::vector<CpuResult> results;
+	{
+		std::unique_lock<std::mutex> lock(m_queue->mutex);
+		if (wait)
+			m_queue->ready.wait(lock, [this]() { return !m_queue->results.empty(); });
+		results.swap(m_queue->results);
+	}
+
+	for (const auto &result : results)
+	{
+		Node &node = m_nodes[result.node];
+		node.cpuDone = true;
+		node.succeeded = result.success;
+		node.cpuMs = result.ms;
+		MarkReady(result.node);
+	}
+}
+
+void LoadGraph::MarkReady(NodeId node)
+{
+	if (m_nodes[node].cpuDone && m_nodes[node].openDependencies == 0)
+		m_ready.push_back(node);
+}
+
+void LoadGraph::RunGl(NodeId id)
+{
+	Node &node = m_nodes[id];
+
+	// Moved out so whatever the stage holds is released here, on the GL thread
+	auto gl = std::move(node.gl);
+	if (gl)
+	{
+		auto start = Clock::now();
+		NodeId previous = m_running;
+		m_running = id;
+		gl();
+		m_running = previous;
+		node.glMs = ToMs(Clock::now() - start);
+	}
+
+	node.glDone = true;
+	TryFinish(id);
+}
+
+void LoadGraph::TryFinish(NodeId id)
+{
+	Node &node = m_nodes[id];
+	if (!node.glDone || node.openChildren > 0 || node.finished)
+		return;
+
+	node.finished = true;
+	node.finishTime = Clock::now();
+	m_finishedCount++;
+
+	for (NodeId dependent : node.dependents)
+	{
+		if (--m_nodes[dependent].openDependencies == 0)
+			MarkReady(dependent);
+	}
+
+	if (node.parent != kNoNode)
+	{
+		m_nodes[node.parent].openChildren--;
+		TryFinish(node.parent);
+	}
+}
+
+LoadGraph::Report LoadGraph::TakeReport()
+{
+	Report report;
+	size_t begin = m_reportBegin;
+	size_t end = m_nodes.size();
+	m_reportBegin = end;
+	if (begin == end)
+		return report;
+
+	Clock::time_point start = m_nodes[begin].added;
+	Clock::time_point finish = start;
+	for (size_t i = begin; i < end; i++)
+	{
+		const Node &node = m_nodes[i];
+		report.nodeCount++;
+		report.failedCount += node.succeeded ? 0 : 1;
+		report.cpuMs += node.cpuMs;
+		report.glMs += node.glMs;
+		finish = std::max(finish, node.finishTime);
+	}
+	report.wallMs = ToMs(finish - start);
+
+	// Replays the batch with every CPU stage starting as soon as it is added (children when their parent's GL stage
+	// starts) and GL stages never waiting for each other. Nodes of earlier batches count as finished at the start.
+	struct Modeled
+	{
+		bool computed = false;
+		double ready = 0.0;
+		double done = 0.0;
+		NodeId limitingDependency = kNoNode;
+		NodeId limitingChild = kNoNode;
+	};
+	std::vector<Modeled> modeled(end - begin);
+	auto inBatch = [begin](NodeId node) { return node != kNoNode && node >= begin; };
+
+	std::function<void(NodeId)> model = [&](NodeId id)
+		{
+			Modeled &m = modeled[id - begin];
+			if (m.computed)
+				return;
+			m.computed = true;
+
+			const Node &node = m_nodes[id];
+			double started = ToMs(node.added - start);
+			if (inBatch(node.parent))
+			{
+				model(node.parent);
+				started = modeled[node.parent - begin].ready;
+			}
+
+			m.ready = started + node.cpuMs;
+			for (NodeId dependency : node.dependencies)
+			{
+				if (!inBatch(dependency))
+					continue;
+				model(dependency);
+				if (modeled[dependency - begin].done > m.ready)
+				{
+					m.ready = modeled[dependency - begin].done;
+					m.limitingDependency = dependency;
+				}
+			}
+
+			m.done = m.ready + node.glMs;
+			for (NodeId child : node.children)
+			{
+				model(child);
+				if (modeled[child - begin].done > m.done)
+				{
+					m.done = modeled[child - begin].done;
+					m.limitingChild = child;
+				}
+			}
+		};
+
+	NodeId last = begin;
+	for (NodeId id = begin; id < end; id++)
+	{
+		model(id);
+		if (modeled[id - begin].done > modeled[last - begin].done)
+			last = id;
+	}
+	report.criticalPathMs = modeled[last - begin].done;
+
+	// Walks back from the last node through whatever it waited for longest
+	std::vector<NodeId> path;
+	std::function<void(NodeId)> walkReady;
+	std::function<void(NodeId)> walkDone = [&](NodeId id)
+		{
+			const Modeled &m = modeled[id - begin];
+			if (m.limitingChild != kNoNode)
+			{
+				walkDone(m.limitingChild);
+				return;
+			}
+			walkReady(id);
+			path.push_back(id);
+		};
+	walkReady = [&](NodeId id)
+		{
+			const Modeled &m = modeled[id - begin];
+			NodeId parent = m_nodes[id].parent;
+			if (m.limitingDependency != kNoNode)
+			{
+				walkDone(m.limitingDependency);
+			}
+			else if (inBatch(parent))
+			{
+				walkReady(parent);
+				path.push_back(parent);
+			}
+		};
+	walkDone(last);
+
+	for (NodeId id : path)
+	{
+		const Node &node = m_nodes[id];
+		std::ostringstream step;
+		step << std::fixed << std::setprecision(1) << node.name << " (" << node.cpuMs << " + " << node.glMs << " ms)";
+		report.criticalPath.push_back(step.str());
+	}
+	return report;
+}
+
+std::string LoadGraph::Report::ToString() const
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(1);
+	out << "Loaded " << nodeCount << " nodes in " << wallMs << " ms";
+	if (failedCount > 0)
+		out << " (" << failedCount << " failed)";
+	out << ", " << cpuMs << " ms on the job system, " << glMs << " ms on the GL thread. ";
+	out << "Critical path " << criticalPathMs << " ms (cpu + gl):";
+	for (size_t i = 0; i < criticalPath.size(); i++)
+		out << (i == 0 ? " " : " > ") << criticalPath[i];
+	return out.str();
+}
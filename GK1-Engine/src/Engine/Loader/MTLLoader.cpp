@@ -1,51 +1,28 @@
 #include "Engine/Loader/Material/MTLLoader.h"
-#include <fstream>
+#include "Engine/FileSystem.h"
 #include <sstream>
 #include <filesystem>
 #include <iostream>
 #include <glm/glm.hpp>
 
-std::vector<std::shared_ptr<Material>> MTLLoader::Load(const std::string &filePath)
+bool MTLLoader::Load(const std::string &filePath, std::vector<MaterialData> &materials)
 {
-	auto mtlData = LoadMTL(filePath);
-	if (!mtlData.success)
-	{
-		std::cerr << "Failed to load MTL file: " << mtlData.error << std::endl;
-		return {};
-	}
-
-	if (mtlData.materials.empty())
-	{
-		std::cerr << "No materials found in MTL file: " << filePath << std::endl;
-		return {};
-	}
-
-	auto materials = std::vector<std::shared_ptr<Material>>();
-
-	for (const auto &[name, material] : mtlData.materials)
-	{
-		materials.push_back(material);
-	}
-
-	return materials;
-}
-
-MTLLoader::MTLData MTLLoader::LoadMTL(const std::string &path) {
-	MTLData result;
-	result.success = false;
+	materials.clear();
 
-	std::ifstream file(path);
-	if (!file.is_open()) {
-		result.error = "Failed to open MTL file: " + path;
-		return result;
+	FileData file;
+	if (!FileSystem::Read(filePath, file)) {
+		std::cerr << "Failed to open MTL file: " << filePath << std::endl;
+		return false;
 	}
 
-	std::shared_ptr<Material> currentMaterial = nullptr;
-	Material::Properties currentMaterialProps;
-	std::string currentMaterialName;
+	MaterialData *currentMaterial = nullptr;
 
+	std::string_view source = file.GetView();
 	std::string line;
-	while (std::getline(file, line)) {
+	while (!source.empty()) {
+		size_t lineEnd = source.find('\n');
+		line.assign(source.substr(0, lineEnd));
+		source.remove_prefix(lineEnd == std::string_view::npos ? source.size() : lineEnd + 1);
 		if (line.empty() || line[0] == '#') continue;
 
 		std::istringstream iss(line);
@@ -55,14 +32,8 @@ MTLLoader::MTLData MTLLoader::LoadMTL(const std::string &path) {
 		// Start a new material
 		if (token == "newmtl")
 		{
-			if (currentMaterial != nullptr)
-				currentMaterial->SetProperties(currentMaterialProps);
-
-			iss >> currentMaterialName;
-			currentMaterial = std::make_shared<Material>();
-			currentMaterialProps = currentMaterial->GetProperties();
-			currentMaterial->SetName(currentMaterialName);
-			result.materials[currentMaterialName] = currentMaterial;
+			currentMaterial = &materials.emplace_back();
+			iss >> currentMaterial->name;
 		}
 		else if (!currentMaterial) 
 		{
@@ -70,75 +41,42 @@ MTLLoader::MTLData MTLLoader::LoadMTL(const std::string &path) {
 		}
 		else if (token == "Ka")
 		{
-			currentMaterialProps.ambient = ParseVec3(line);
+			currentMaterial->properties.ambient = ParseVec3(line);
 		}
 		else if (token == "Kd")
 		{
-			currentMaterialProps.diffuse = ParseVec3(line);
+			currentMaterial->properties.diffuse = ParseVec3(line);
 		}
 		else if (token == "Ks")
 		{
-			currentMaterialProps.specular = ParseVec3(line);
+			currentMaterial->properties.specular = ParseVec3(line);
 		}
 		else if (token == "Ns")
 		{
-			currentMaterialProps.shininess = ParseFloat(line);
-		}
-		else if (token == "map_Ka")
-		{
-			std::string texPath = ParseTexture(line, path);
-			if (!texPath.empty()) 
-			{
-				auto texture = Texture::LoadFromFile(texPath);
-				if (texture)
-				{
-					currentMaterial->AddTexture(Texture::TextureType::Ambient, texture);
-				}
-			}
-		}
-		else if (token == "map_Kd")
-		{
-			std::string texPath = ParseTexture(line, path);
-			if (!texPath.empty())
-			{
-				auto texture = Texture::LoadFromFile(texPath);
-				if (texture)
-				{
-					currentMaterial->AddTexture(Texture::TextureType::Diffuse, texture);
-				}
-			}
-		}
-		else if (token == "map_Ks")
-		{
-			std::string texPath = ParseTexture(line, path);
-			if (!texPath.empty())
-			{
-				auto texture = Texture::LoadFromFile(texPath);
-				if (texture)
-				{
-					currentMaterial->AddTexture(Texture::TextureType::Specular, texture);
-				}
-			}
+			currentMaterial->properties.shininess = ParseFloat(line);
 		}
-		else if (token == "map_Kn" || token == "norm")
+		else if (token == "map_Ka" || token == "map_Kd" || token == "map_Ks" || token == "map_Kn" || token == "norm")
 		{
-			std::string texPath = ParseTexture(line, path);
-			if (!texPath.empty())
-			{
-				auto texture = Texture::LoadFromFile(texPath);
-				if (texture)
-				{
-					currentMaterial->AddTexture(Texture::TextureType::Normal, texture);
-				}
-			}
+			std::string texPath = ParseTexture(line, filePath);
+			if (texPath.empty()) continue;
+
+			Texture::TextureType type = Texture::TextureType::Normal;
+			if (token == "map_Ka")
+				type = Texture::TextureType::Ambient;
+			else if (token == "map_Kd")
+				type = Texture::TextureType::Diffuse;
+			else if (token == "map_Ks")
+				type = Texture::TextureType::Specular;
+			currentMaterial->textures.emplace_back(type, texPath);
 		}
 	}
 
-	if (currentMaterial != nullptr)
-		currentMaterial->SetProperties(currentMaterialProps);
-
-	result.success = true;
-	return result;
+	if (materials.empty())
+	{
+		std::cerr << "No materials found in MTL file: " << filePath << std::endl;
+		return false;
+	}
+	return true;
 }
 
 glm::vec3 MTLLoader::ParseVec3(const std::string &line) {
@@ -0,0 +1,302 @@
+#include "Engine/Loader/Model/ModelCache.h"
+#include "Engine/FileSystem.h"
+#include "Engine/Profiler.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <system_error>
+
+namespace
+{
+	constexpr char kMagic[4] = { 'G', 'K', '1', 'M' };
+	constexpr size_t kDataAlignment = 16;
+
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t vertexSize;
+		uint32_t meshCount;
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t sourceHash;
+		uint32_t libraryCount;
+		uint32_t reserved;
+	};
+
+	struct MeshRecord
+	{
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+	};
+
+	// FNV-1a, only used to tell whether a touched source actually changed
+	uint64_t HashBytes(std::string_view bytes)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : bytes)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	bool HashFile(const std::string &path, uint64_t &hash)
+	{
+		FileData file;
+		if (!FileSystem::Read(path, file)) return false;
+		hash = HashBytes(file.GetView());
+		return true;
+	}
+
+	bool GetSourceInfo(const std::string &path, uint64_t &size, int64_t &time)
+	{
+		FileSystem::Info info;
+		if (!FileSystem::GetInfo(path, info)) return false;
+		size = info.size;
+		time = info.time;
+		return true;
+	}
+
+	// Patches the header in place, the rest of the file stays valid
+	bool WriteSourceTime(const std::string &path, int64_t time)
+	{
+		std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+		if (!out) return false;
+		out.seekp(offsetof(FileHeader, sourceTime));
+		out.write(reinterpret_cast<const char *>(&time), sizeof(time));
+		return static_cast<bool>(out);
+	}
+
+	size_t AlignUp(size_t value)
+	{
+		return (value + kDataAlignment - 1) & ~(kDataAlignment - 1);
+	}
+
+	// Bounds-checked reads from the file contents
+	class Reader
+	{
+	public:
+		explicit Reader(std::string_view data) : m_data(data) {}
+
+		template <typename T>
+		bool Read(T &value)
+		{
+			if (m_data.size() - m_offset < sizeof(T)) return false;
+			std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+			return true;
+		}
+
+		bool ReadString(std::string &value)
+		{
+			uint32_t length;
+			if (!Read(length) || m_data.size() - m_offset < length) return false;
+			value.assign(m_data.data() + m_offset, length);
+			m_offset += length;
+			return true;
+		}
+
+		template <typename T>
+		bool GetSpan(uint64_t offset, uint32_t count, std::span<const T> &span) const
+		{
+			if (offset % alignof(T) != 0 || offset > m_data.size()) return false;
+			if ((m_data.size() - offset) / sizeof(T) < count) return false;
+			span = std::span<const T>(reinterpret_cast<const T *>(m_data.data() + offset), count);
+			return true;
+		}
+
+	private:
+		std::string_view m_data;
+		size_t m_offset = 0;
+	};
+
+	void WriteString(std::ofstream &out, const std::string &value)
+	{
+		uint32_t length = static_cast<uint32_t>(value.size());
+		out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+		out.write(value.data(), length);
+	}
+
+	void WritePadding(std::ofstream &out, size_t &offset)
+	{
+		static constexpr char kZeros[kDataAlignment] = {};
+		size_t aligned = AlignUp(offset);
+		out.write(kZeros, aligned - offset);
+		offset = aligned;
+	}
+}
+
+std::string ModelCache::GetCachePath(const std::string &sourcePath)
+{
+	return std::filesystem::path(sourcePath).replace_extension(".gk1mesh").string();
+}
+
+bool ModelCache::Load(const std::string &sourcePath, ModelData &data)
+{
+	PROFILE_SCOPE("ModelCache::Load");
+
+	std::string cachePath = GetCachePath(sourcePath);
+	FileData file;
+	if (!FileSystem::Read(cachePath, file)) return false;
+
+	Reader reader(file.GetView());
+	FileHeader header;
+	if (!reader.Read(header)
+		|| std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0
+		|| header.version != kVersion
+		|| header.vertexSize != sizeof(Geometry::Vertex))
+	{
+		return false;
+	}
+
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	if (!GetSourceInfo(sourcePath, sourceSize, sourceTime) || sourceSize != header.sourceSize) return false;
+
+	// A new timestamp alone (checkout, copy) does not invalidate the cooked data
+	if (sourceTime != header.sourceTime)
+	{
+		uint64_t sourceHash;
+		if (!HashFile(sourcePath, sourceHash) || sourceHash != header.sourceHash) return false;
+
+		// Stored so the next load skips the hash. Windows does not let the mapped file be written, so it is closed first.
+		if (!FileSystem::IsPacked(cachePath))
+		{
+			file = FileData();
+			if (!WriteSourceTime(cachePath, sourceTime))
+				std::cerr << "Cannot update cooked model: " << cachePath << std::endl;
+
+			if (!FileSystem::Read(cachePath, file)) return false;
+			reader = Reader(file.GetView());
+			if (!reader.Read(header) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return false;
+		}
+	}
+
+	data = ModelData();
+	std::filesystem::path sourceDir = std::filesystem::path(sourcePath).parent_path();
+	for (uint32_t i = 0; i < header.libraryCount; i++)
+	{
+		std::string library;
+		if (!reader.ReadString(library)) return false;
+		data.materialLibraries.push_back((sourceDir / library).string());
+	}
+
+	data.meshes.resize(header.meshCount);
+	for (auto &mesh : data.meshes)
+	{
+		MeshRecord record;
+		if (!reader.ReadString(mesh.name) || !reader.ReadString(mesh.material) || !reader.Read(record)
+			|| !reader.GetSpan(record.vertexOffset, record.vertexCount, mesh.cookedVertices)
+			|| !reader.GetSpan(record.indexOffset, record.indexCount, mesh.cookedIndices))
+		{
+			std::cerr << "Corrupt cooked model: " << cachePath << std::endl;
+			data = ModelData();
+			return false;
+		}
+	}
+
+	// Moving keeps the mapping and the views into it valid, Build uploads straight from them
+	data.file = std::make_shared<const FileData>(std::move(file));
+	return true;
+}
+
+bool ModelCache::Write(const std::string &sourcePath, const ModelData &data)
+{
+	PROFILE_SCOPE("ModelCache::Write");
+
+	FileHeader header{};
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.vertexSize = sizeof(Geometry::Vertex);
+	header.meshCount = static_cast<uint32_t>(data.meshes.size());
+	header.libraryCount = static_cast<uint32_t>(data.materialLibraries.size());
+	if (!GetSourceInfo(sourcePath, header.sourceSize, header.sourceTime) || !HashFile(sourcePath, header.sourceHash))
+		return false;
+
+	// Libraries are stored relative to the source so the cooked file survives moving the asset folder
+	std::filesystem::path sourceDir = std::filesystem::path(sourcePath).parent_path();
+	std::vector<std::string> libraries;
+	size_t offset = sizeof(FileHeader);
+	for (const auto &library : data.materialLibraries)
+	{
+		libraries.push_back(std::filesystem::path(library).lexically_proximate(sourceDir).generic_string());
+		offset += sizeof(uint32_t) + libraries.back().size();
+	}
+
+	// Lay out the data blocks after the mesh table
+	std::vector<MeshRecord> records;
+	for (const auto &mesh : data.meshes)
+	{
+		offset += 2 * sizeof(uint32_t) + mesh.name.size() + mesh.material.size() + sizeof(MeshRecord);
+	}
+	for (const auto &mesh : data.meshes)
+	{
+		MeshRecord record{};
+		record.vertexCount = static_cast<uint32_t>(mesh.GetVertices().size());
+		record.indexCount = static_cast<uint32_t>(mesh.GetIndices().size());
+		record.vertexOffset = offset = AlignUp(offset);
+		offset += record.vertexCount * sizeof(Geometry::Vertex);
+		record.indexOffset = offset = AlignUp(offset);
+		offset += record.indexCount * sizeof(uint32_t);
+		records.push_back(record);
+	}
+
+	// Write to a temporary file first so a crash never leaves a truncated cache behind
+	std::string cachePath = GetCachePath(sourcePath);
+	std::string tempPath = cachePath + ".tmp";
+	bool success;
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out) return false;
+
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		for (const auto &library : libraries)
+		{
+			WriteString(out, library);
+		}
+
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			const auto &mesh = data.meshes[i];
+			WriteString(out, mesh.name);
+			WriteString(out, mesh.material);
+			out.write(reinterpret_cast<const char *>(&records[i]), sizeof(MeshRecord));
+		}
+
+		size_t written = static_cast<size_t>(out.tellp());
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			const auto &mesh = data.meshes[i];
+
+			WritePadding(out, written);
+			out.write(reinterpret_cast<const char *>(mesh.GetVertices().data()), records[i].vertexCount * sizeof(Geometry::Vertex));
+			written += records[i].vertexCount * sizeof(Geometry::Vertex);
+
+			WritePadding(out, written);
+			out.write(reinterpret_cast<const char *>(mesh.GetIndices().data()), records[i].indexCount * sizeof(uint32_t));
+			written += records[i].indexCount * sizeof(uint32_t);
+		}
+
+		success = static_cast<bool>(out);
+	}
+
+	std::error_code error;
+	if (success)
+	{
+		std::filesystem::rename(tempPath, cachePath, error);
+	}
+	if (!success || error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
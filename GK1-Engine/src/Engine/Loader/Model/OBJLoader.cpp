@@ -1,156 +1,415 @@
 #include "Engine/Loader/Model/OBJLoader.h"
 
-#include <fstream>
-#include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <filesystem>
+#include <functional>
 
-#include <Engine/Loader/LoaderFactory.h>
-#include <Engine/Loader/Material/MaterialLoader.h>
+#include <Engine/FileSystem.h>
+#include <Engine/JobSystem.h>
+#include <Engine/Profiler.h>
 
-std::shared_ptr<Model> OBJLoader::Load(const std::string &filePath) {
-	auto model = std::make_shared<Model>();
+namespace
+{
+	struct FaceCorner {
+		uint32_t position;
+		uint32_t uv;
+		uint32_t normal;
+	};
+
+	// Number of attributes defined so far, face indices are validated and made absolute against these
+	struct AttributeCounts {
+		size_t positions = 0;
+		size_t uvs = 0;
+		size_t normals = 0;
+	};
+
+	// Group and material directives of a chunk, faces before cornerOffset belong to the state preceding the event
+	struct ChunkEvent {
+		enum class Type { Group, Material, MaterialLibrary };
+		Type type;
+		std::string name;
+		size_t cornerOffset;
+	};
+
+	struct ChunkData {
+		std::string_view source;
+		AttributeCounts base;
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec3> normals;
+		std::vector<uint32_t> vertexIndices;
+		std::vector<uint32_t> uvIndices;
+		std::vector<uint32_t> normalIndices;
+		std::vector<ChunkEvent> events;
+	};
+
+	// Files are split into chunks of roughly this size at line boundaries
+	constexpr size_t kChunkSize = 1 << 20;
+
+	bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
 
-	auto objData = LoadOBJ(filePath);
-	if (!objData.success) {
-		std::cerr << "Failed to load model: " << objData.error << std::endl;
-		return nullptr;
+	std::string_view NextToken(const char *&p, const char *end)
+	{
+		while (p < end && IsSpace(*p)) ++p;
+		const char *start = p;
+		while (p < end && !IsSpace(*p)) ++p;
+		return std::string_view(start, p - start);
 	}
 
-	// Create mesh components for each mesh in the data
-	for (const auto &meshData : objData.meshes) {
-		Mesh mesh;
-		mesh.geometry = std::make_shared<Geometry>(meshData.vertices, meshData.indices);
-		mesh.material = meshData.material ? meshData.material : std::make_shared<Material>();
-		mesh.SetName(meshData.name);
+	float ParseFloat(const char *&p, const char *end)
+	{
+		while (p < end && IsSpace(*p)) ++p;
+		if (p < end && *p == '+') ++p;
 
-		model->AddMesh(mesh);
+		float value = 0.0f;
+		auto [ptr, ec] = std::from_chars(p, end, value);
+		if (ec == std::errc())
+			p = ptr;
+		else
+			NextToken(p, end);
+		return value;
 	}
 
-	return model;
-}
+	// OBJ indices are 1-based, negative ones are relative to the end of the attribute list
+	uint32_t ParseIndex(const char *&p, const char *end, size_t count)
+	{
+		int64_t value = 0;
+		auto [ptr, ec] = std::from_chars(p, end, value);
+		if (ec != std::errc())
+			return OBJLoader::kMissingIndex;
+		p = ptr;
+
+		int64_t index = value > 0 ? value - 1 : static_cast<int64_t>(count) + value;
+		if (value == 0 || index < 0 || index >= static_cast<int64_t>(count))
+			return OBJLoader::kMissingIndex;
+		return static_cast<uint32_t>(index);
+	}
 
-OBJLoader::OBJData OBJLoader::LoadOBJ(const std::string &path) {
-	OBJData result;
-	result.success = false;
+	// Reads the "v", "v/vt", "v//vn" or "v/vt/vn" corners of a face, faces with invalid positions are dropped
+	void ParseFace(const char *&p, const char *end, const AttributeCounts &counts, std::vector<FaceCorner> &corners)
+	{
+		corners.clear();
+		while (true) {
+			while (p < end && IsSpace(*p)) ++p;
+			if (p == end) break;
+
+			FaceCorner corner{ OBJLoader::kMissingIndex, OBJLoader::kMissingIndex, OBJLoader::kMissingIndex };
+			corner.position = ParseIndex(p, end, counts.positions);
+			if (p < end && *p == '/') {
+				++p;
+				if (p < end && *p != '/')
+					corner.uv = ParseIndex(p, end, counts.uvs);
+				if (p < end && *p == '/') {
+					++p;
+					corner.normal = ParseIndex(p, end, counts.normals);
+				}
+			}
 
-	std::ifstream file(path);
-	if (!file.is_open()) {
-		result.error = "Failed to open file: " + path;
-		return result;
+			if (corner.position == OBJLoader::kMissingIndex) {
+				corners.clear();
+				return;
+			}
+
+			// Skip anything unexpected up to the next corner
+			while (p < end && !IsSpace(*p)) ++p;
+			corners.push_back(corner);
+		}
 	}
 
-	std::vector<glm::vec3> temp_positions;
-	std::vector<glm::vec2> temp_uvs;
-	std::vector<glm::vec3> temp_normals;
+	// Open-addressing map from a packed (position, uv) index pair to a vertex index. The normal index is not part
+	// of the key since vertex normals are smoothed per position and would only produce identical duplicates.
+	class VertexTable {
+	public:
+		explicit VertexTable(size_t maxEntries)
+		{
+			// At most half full so probe sequences stay short
+			size_t capacity = 16;
+			while (capacity < maxEntries * 2) capacity <<= 1;
 
-	// Current group/object data
-	std::string currentGroupName = "default";
-	std::string currentMaterial;
-	std::unordered_map<std::string, TempMeshData> meshGroups;
-	meshGroups[currentGroupName] = TempMeshData();
+			m_keys.assign(capacity, kEmpty);
+			m_values.resize(capacity);
+			m_mask = capacity - 1;
+		}
 
-	std::string line;
-	while (std::getline(file, line)) {
-		std::istringstream iss(line);
-		std::string type;
-		iss >> type;
+		// Returns the stored index and whether the key was new
+		std::pair<uint32_t, bool> Insert(uint32_t position, uint32_t uv, uint32_t value)
+		{
+			uint64_t key = (static_cast<uint64_t>(position) << 32) | uv;
+			size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
 
-		if (type == "v") {
-			temp_positions.push_back(ParseVec3(line));
-		}
-		else if (type == "vt") {
-			temp_uvs.push_back(ParseVec2(line));
-		}
-		else if (type == "vn") {
-			temp_normals.push_back(ParseVec3(line));
+			while (m_keys[slot] != kEmpty) {
+				if (m_keys[slot] == key)
+					return { m_values[slot], false };
+				slot = (slot + 1) & m_mask;
+			}
+
+			m_keys[slot] = key;
+			m_values[slot] = value;
+			return { value, true };
 		}
-		else if (type == "f") {
-			ParseFace(line,
-				meshGroups[currentGroupName].vertexIndices,
-				meshGroups[currentGroupName].uvIndices,
-				meshGroups[currentGroupName].normalIndices);
+
+	private:
+		// Positions are never kMissingIndex, so no real key has all bits set
+		static constexpr uint64_t kEmpty = UINT64_MAX;
+
+		std::vector<uint64_t> m_keys;
+		std::vector<uint32_t> m_values;
+		size_t m_mask;
+	};
+
+	template<typename F>
+	void ForEachLine(std::string_view source, F &&body)
+	{
+		const char *cursor = source.data();
+		const char *end = source.data() + source.size();
+		while (cursor < end) {
+			const char *lineEnd = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+			if (!lineEnd) lineEnd = end;
+
+			body(cursor, lineEnd);
+			cursor = lineEnd + 1;
 		}
-		else if (type == "g" || type == "o") {
-			// Start new group/object
-			std::string name;
-			iss >> name;
-			if (!name.empty()) {
-				currentGroupName = name;
-				if (meshGroups.find(currentGroupName) == meshGroups.end()) {
-					meshGroups[currentGroupName] = TempMeshData();
-					meshGroups[currentGroupName].material = currentMaterial;
+	}
+
+	// Stores the chunk's own attribute counts in chunk.base until the prefix sum replaces them
+	void CountAttributes(ChunkData &chunk)
+	{
+		AttributeCounts counts;
+		ForEachLine(chunk.source, [&counts](const char *p, const char *lineEnd) {
+			std::string_view type = NextToken(p, lineEnd);
+			if (type == "v") counts.positions++;
+			else if (type == "vt") counts.uvs++;
+			else if (type == "vn") counts.normals++;
+		});
+		chunk.base = counts;
+	}
+
+	void ParseChunk(ChunkData &chunk)
+	{
+		std::vector<FaceCorner> corners;
+
+		ForEachLine(chunk.source, [&chunk, &corners](const char *p, const char *lineEnd) {
+			std::string_view type = NextToken(p, lineEnd);
+			if (type.empty() || type[0] == '#') return;
+
+			if (type == "v") {
+				glm::vec3 position;
+				position.x = ParseFloat(p, lineEnd);
+				position.y = ParseFloat(p, lineEnd);
+				position.z = ParseFloat(p, lineEnd);
+				chunk.positions.push_back(position);
+			}
+			else if (type == "vt") {
+				glm::vec2 uv;
+				uv.x = ParseFloat(p, lineEnd);
+				uv.y = ParseFloat(p, lineEnd);
+				chunk.uvs.push_back(uv);
+			}
+			else if (type == "vn") {
+				glm::vec3 normal;
+				normal.x = ParseFloat(p, lineEnd);
+				normal.y = ParseFloat(p, lineEnd);
+				normal.z = ParseFloat(p, lineEnd);
+				chunk.normals.push_back(normal);
+			}
+			else if (type == "f") {
+				AttributeCounts counts{
+					chunk.base.positions + chunk.positions.size(),
+					chunk.base.uvs + chunk.uvs.size(),
+					chunk.base.normals + chunk.normals.size()
+				};
+				ParseFace(p, lineEnd, counts, corners);
+
+				// Triangulate polygons as a fan around the first corner
+				for (size_t i = 1; i + 1 < corners.size(); ++i) {
+					for (const FaceCorner &corner : { corners[0], corners[i], corners[i + 1] }) {
+						chunk.vertexIndices.push_back(corner.position);
+						chunk.uvIndices.push_back(corner.uv);
+						chunk.normalIndices.push_back(corner.normal);
+					}
 				}
 			}
-		}
-		else if (type == "mtllib") {
-			std::string mtlFile;
-			iss >> mtlFile;
-			std::filesystem::path objPath(path);
-			std::filesystem::path mtlPath = objPath.parent_path() / mtlFile;
-			std::string ext = mtlPath.extension().string();
-
-			auto mtlFactory = LoaderFactory<MaterialLoader>::CreateLoader(ext);
-			auto mtlData = mtlFactory->Load(mtlPath.string());
-			if (!mtlData.empty()) {
-				m_materials.insert(m_materials.end(), mtlData.begin(), mtlData.end());
+			else if (type == "g" || type == "o") {
+				std::string_view name = NextToken(p, lineEnd);
+				if (!name.empty())
+					chunk.events.push_back({ ChunkEvent::Type::Group, std::string(name), chunk.vertexIndices.size() });
 			}
-			else {
-				std::cerr << "Failed to load materials from MTL file: " << mtlPath << std::endl;
+			else if (type == "mtllib") {
+				for (std::string_view mtlFile = NextToken(p, lineEnd); !mtlFile.empty(); mtlFile = NextToken(p, lineEnd))
+					chunk.events.push_back({ ChunkEvent::Type::MaterialLibrary, std::string(mtlFile), chunk.vertexIndices.size() });
 			}
-		}
-		else if (type == "usemtl") {
-			iss >> currentMaterial;
-
-			// If material changes within a group, create a new group with unique name
-			if (!meshGroups[currentGroupName].vertexIndices.empty() &&
-				meshGroups[currentGroupName].material != currentMaterial) {
-				std::string newGroupName = currentGroupName + "_" + currentMaterial;
-				currentGroupName = newGroupName;
-				meshGroups[currentGroupName] = TempMeshData();
+			else if (type == "usemtl") {
+				chunk.events.push_back({ ChunkEvent::Type::Material, std::string(NextToken(p, lineEnd)), chunk.vertexIndices.size() });
 			}
-			meshGroups[currentGroupName].material = currentMaterial;
-		}
+		});
 	}
+}
+
+bool OBJLoader::Load(const std::string &filePath, ModelData &data) {
+	FileData file;
+	if (!FileSystem::Read(filePath, file)) {
+		std::cerr << "Failed to open file: " << filePath << std::endl;
+		return false;
+	}
+
+	ParsedOBJ parsed;
+	ParseOBJ(file.GetView(), parsed);
+
+	// Materials are created on the GL thread, only their libraries are resolved here
+	std::filesystem::path objDir = std::filesystem::path(filePath).parent_path();
+	for (const auto &mtlFile : parsed.materialLibraries)
+		data.materialLibraries.push_back((objDir / mtlFile).string());
 
 	// Process all mesh groups
-	for (const auto &[groupName, tempMesh] : meshGroups) {
-		if (tempMesh.vertexIndices.empty()) continue;
-
-		MeshData meshData = ProcessMeshData(temp_positions, temp_uvs, temp_normals, tempMesh, groupName);
-
-		// Assign material
-		if (!tempMesh.material.empty()) {
-			auto it = std::find_if(m_materials.begin(), m_materials.end(), 
-				[&tempMesh](std::shared_ptr<Material> material)
-				{
-					return material->GetName() == tempMesh.material;
-				});
-			if (it != m_materials.end()) {
-				meshData.material = *it;
-			}
-		}
+	for (const auto &group : parsed.groups) {
+		if (group.vertexIndices.empty()) continue;
 
-		result.meshes.push_back(std::move(meshData));
+		MeshData meshData = ProcessMeshData(parsed, group);
+		meshData.material = group.material;
+		data.meshes.push_back(std::move(meshData));
 	}
 
-	result.success = true;
-	return result;
+	return true;
 }
 
-OBJLoader::MeshData OBJLoader::ProcessMeshData(
-	const std::vector<glm::vec3> &positions,
-	const std::vector<glm::vec2> &uvs,
-	const std::vector<glm::vec3> &normals,
-	const TempMeshData &tempMesh,
-	const std::string &name) {
+void OBJLoader::ParseOBJ(std::string_view source, ParsedOBJ &parsed) {
+	// Split at line boundaries
+	std::vector<ChunkData> chunks;
+	size_t chunkStart = 0;
+	while (chunkStart < source.size()) {
+		size_t chunkEnd = std::min(chunkStart + kChunkSize, source.size());
+		size_t newline = source.find('\n', chunkEnd - 1);
+		chunkEnd = newline == std::string_view::npos ? source.size() : newline + 1;
+
+		chunks.emplace_back();
+		chunks.back().source = source.substr(chunkStart, chunkEnd - chunkStart);
+		chunkStart = chunkEnd;
+	}
+
+	auto forEachChunk = [&chunks](const std::function<void(ChunkData &)> &body) {
+		if (chunks.size() == 1)
+			body(chunks[0]);
+		else
+			JobSystem::Get().ParallelFor(chunks.size(), [&chunks, &body](size_t i) { body(chunks[i]); });
+	};
+
+	// Relative face indices need the number of attributes defined before each chunk, count them first
+	forEachChunk([](ChunkData &chunk) {
+		PROFILE_SCOPE("OBJLoader::CountChunk");
+		CountAttributes(chunk);
+	});
+
+	AttributeCounts total;
+	for (auto &chunk : chunks) {
+		AttributeCounts local = chunk.base;
+		chunk.base = total;
+		total.positions += local.positions;
+		total.uvs += local.uvs;
+		total.normals += local.normals;
+	}
+
+	forEachChunk([](ChunkData &chunk) {
+		PROFILE_SCOPE("OBJLoader::ParseChunk");
+		ParseChunk(chunk);
+	});
+
+	PROFILE_SCOPE("OBJLoader::MergeChunks");
+	parsed.positions.resize(total.positions);
+	parsed.uvs.resize(total.uvs);
+	parsed.normals.resize(total.normals);
+	forEachChunk([&parsed](ChunkData &chunk) {
+		std::copy(chunk.positions.begin(), chunk.positions.end(), parsed.positions.begin() + chunk.base.positions);
+		std::copy(chunk.uvs.begin(), chunk.uvs.end(), parsed.uvs.begin() + chunk.base.uvs);
+		std::copy(chunk.normals.begin(), chunk.normals.end(), parsed.normals.begin() + chunk.base.normals);
+	});
+
+	// Replay group/material directives in file order
+	std::string currentMaterial;
+	std::unordered_map<std::string, size_t> groupIndices;
+	size_t currentGroup = 0;
+	parsed.groups.emplace_back("default");
+	groupIndices["default"] = 0;
+
+	auto selectGroup = [&](std::string name) {
+		auto it = groupIndices.find(name);
+		if (it != groupIndices.end()) {
+			currentGroup = it->second;
+			return false;
+		}
+		currentGroup = parsed.groups.size();
+		groupIndices.emplace(name, currentGroup);
+		parsed.groups.emplace_back(std::move(name));
+		return true;
+	};
+
+	for (const auto &chunk : chunks) {
+		size_t corner = 0;
+		auto appendFaces = [&](size_t end) {
+			GroupData &group = parsed.groups[currentGroup];
+			group.vertexIndices.insert(group.vertexIndices.end(), chunk.vertexIndices.begin() + corner, chunk.vertexIndices.begin() + end);
+			group.uvIndices.insert(group.uvIndices.end(), chunk.uvIndices.begin() + corner, chunk.uvIndices.begin() + end);
+			group.normalIndices.insert(group.normalIndices.end(), chunk.normalIndices.begin() + corner, chunk.normalIndices.begin() + end);
+			corner = end;
+		};
+
+		for (const auto &event : chunk.events) {
+			appendFaces(event.cornerOffset);
+
+			switch (event.type) {
+				case ChunkEvent::Type::Group:
+					// Start new group/object
+					if (selectGroup(event.name))
+						parsed.groups[currentGroup].material = currentMaterial;
+					break;
+				case ChunkEvent::Type::MaterialLibrary:
+					parsed.materialLibraries.push_back(event.name);
+					break;
+				case ChunkEvent::Type::Material: {
+					currentMaterial = event.name;
+
+					// If material changes within a group, create a new group with unique name
+					const GroupData &group = parsed.groups[currentGroup];
+					if (!group.vertexIndices.empty() && group.material != currentMaterial) {
+						selectGroup(group.name + "_" + currentMaterial);
+					}
+					parsed.groups[currentGroup].material = currentMaterial;
+					break;
+				}
+			}
+		}
+		appendFaces(chunk.vertexIndices.size());
+	}
+}
+
+OBJLoader::MeshData OBJLoader::ProcessMeshData(const ParsedOBJ &parsed, const GroupData &group) {
+	const auto &positions = parsed.positions;
+	const auto &uvs = parsed.uvs;
+	const auto &normals = parsed.normals;
+	const GroupData &tempMesh = group;
 
 	MeshData meshData;
-	meshData.name = name;
+	meshData.name = group.name;
+
+	// Compact the positions this group references so the normal buffers scale with the group, not the file.
+	// The position-to-local map is sized to the file once per thread and only the touched entries are reset.
+	thread_local std::vector<uint32_t> localPositions;
+	if (localPositions.size() < positions.size())
+		localPositions.resize(positions.size(), kMissingIndex);
+
+	uint32_t localCount = 0;
+	for (uint32_t posIndex : tempMesh.vertexIndices) {
+		if (localPositions[posIndex] == kMissingIndex)
+			localPositions[posIndex] = localCount++;
+	}
 
-	std::vector<glm::vec3> accumulatedNormals(positions.size(), glm::vec3(0.0f));
-	std::vector<uint32_t> normalCounts(positions.size(), 0);
+	std::vector<glm::vec3> accumulatedNormals(localCount, glm::vec3(0.0f));
+	std::vector<uint32_t> normalCounts(localCount, 0);
 
 	// Accumulate face normals
 	for (size_t i = 0; i < tempMesh.vertexIndices.size(); i += 3) {
@@ -165,7 +424,7 @@ OBJLoader::MeshData OBJLoader::ProcessMeshData(
 		glm::vec3 v2 = positions[posIndices[2]];
 		glm::vec3 faceNormal;
 
-		if (tempMesh.normalIndices.empty())
+		if (tempMesh.normalIndices[i] >= normals.size())
 		{
 			glm::vec3 edge1 = v1 - v0;
 			glm::vec3 edge2 = v2 - v0;
@@ -177,139 +436,42 @@ OBJLoader::MeshData OBJLoader::ProcessMeshData(
 		}
 
 		for (int j = 0; j < 3; ++j) {
-			accumulatedNormals[posIndices[j]] += faceNormal;
-			normalCounts[posIndices[j]]++;
+			accumulatedNormals[localPositions[posIndices[j]]] += faceNormal;
+			normalCounts[localPositions[posIndices[j]]]++;
 		}
 	}
 
-	for (size_t i = 0; i < positions.size(); ++i) {
+	for (size_t i = 0; i < accumulatedNormals.size(); ++i) {
 		if (normalCounts[i] > 0) {
 			accumulatedNormals[i] = glm::normalize(accumulatedNormals[i] / static_cast<float>(normalCounts[i]));
 		}
 	}
 
-	// Map to store unique vertices
-	std::unordered_map<std::string, uint32_t> uniqueVertices;
+	// Unique vertices keyed by their position and uv index
+	VertexTable uniqueVertices(tempMesh.vertexIndices.size());
+	meshData.indices.reserve(tempMesh.vertexIndices.size());
 
 	for (size_t i = 0; i < tempMesh.vertexIndices.size(); ++i) {
-		Geometry::Vertex vertex;
-
 		uint32_t posIndex = tempMesh.vertexIndices[i];
-		uint32_t uvIndex = i < tempMesh.uvIndices.size() ? tempMesh.uvIndices[i] : 0;
-
-		vertex.position = positions[posIndex];
-		vertex.texCoords = (uvIndex < uvs.size()) ? uvs[uvIndex] : glm::vec2(0.0f);
-		vertex.normal = accumulatedNormals[posIndex];
-
-		// Create a unique key for the vertex
-		std::stringstream ss;
-		ss << posIndex << '_' << uvIndex;
-		std::string key = ss.str();
-
-		// Check if the vertex already exists
-		if (uniqueVertices.count(key) == 0) {
-			uniqueVertices[key] = static_cast<uint32_t>(meshData.vertices.size());
+		uint32_t uvIndex = tempMesh.uvIndices[i];
+
+		auto [index, inserted] = uniqueVertices.Insert(posIndex, uvIndex, static_cast<uint32_t>(meshData.vertices.size()));
+		if (inserted) {
+			Geometry::Vertex vertex;
+			vertex.position = positions[posIndex];
+			vertex.texCoords = (uvIndex < uvs.size()) ? uvs[uvIndex] : glm::vec2(0.0f);
+			vertex.normal = accumulatedNormals[localPositions[posIndex]];
 			meshData.vertices.push_back(vertex);
 		}
 
-		meshData.indices.push_back(uniqueVertices[key]);
+		meshData.indices.push_back(index);
 	}
 
+	for (uint32_t posIndex : tempMesh.vertexIndices)
+		localPositions[posIndex] = kMissingIndex;
+
 	// Calculate tangents and bitangents
-	CalculateTangents(meshData.vertices, meshData.indices);
+	Geometry::CalculateTangents(meshData.vertices, meshData.indices);
 
 	return meshData;
 }
-
-void OBJLoader::CalculateTangents(std::vector<Geometry::Vertex> &vertices, const std::vector<uint32_t> &indices)
-{
-	for (auto &vertex : vertices)
-	{
-		vertex.tangent = glm::vec3(0.0f);
-		vertex.bitangent = glm::vec3(0.0f);
-	}
-
-	std::unordered_map<uint32_t, uint32_t> tangentCount;
-	std::unordered_map<uint32_t, uint32_t> bitangentCount;
-
-	for (size_t i = 0; i < indices.size(); i += 3)
-	{
-		// Get the vertices
-		Geometry::Vertex &v0 = vertices[indices[i]];
-		Geometry::Vertex &v1 = vertices[indices[i + 1]];
-		Geometry::Vertex &v2 = vertices[indices[i + 2]];
-
-		// Calculate the edges
-		glm::vec3 edge1 = v1.position - v0.position;
-		glm::vec3 edge2 = v2.position - v0.position;
-
-		// Calculate the UV deltas
-		glm::vec2 deltaUV1 = v1.texCoords - v0.texCoords;
-		glm::vec2 deltaUV2 = v2.texCoords - v0.texCoords;
-
-		// Calculate the tangent and bitangent
-		float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-		if (std::isinf(f)) f = 1.0f;
-		glm::vec3 tangent(f * (deltaUV2.y * edge1 - deltaUV1.y * edge2));
-		glm::vec3 bitangent(f * (deltaUV1.x * edge2 - deltaUV2.x * edge1));
-
-		// Accumulate the tangent and bitangent
-		for (int j = 0; j < 3; ++j)
-		{
-			vertices[indices[i + j]].tangent += tangent;
-			tangentCount[indices[i + j]]++;
-
-			vertices[indices[i + j]].bitangent += bitangent;
-			bitangentCount[indices[i + j]]++;
-		}
-	}
-
-	// Normalize the tangents and bitangents
-	for (int i = 0; i < vertices.size(); ++i)
-	{
-		vertices[i].tangent = glm::normalize(vertices[i].tangent / static_cast<float>(tangentCount[i]));
-		vertices[i].bitangent = glm::normalize(vertices[i].bitangent / static_cast<float>(bitangentCount[i]));
-	}
-}
-
-glm::vec3 OBJLoader::ParseVec3(const std::string &line)
-{
-	glm::vec3 result;
-	std::istringstream iss(line);
-	std::string type;
-	iss >> type >> result.x >> result.y >> result.z;
-	return result;
-}
-
-glm::vec2 OBJLoader::ParseVec2(const std::string &line)
-{
-	glm::vec2 result;
-	std::istringstream iss(line);
-	std::string type;
-	iss >> type >> result.x >> result.y;
-	return result;
-}
-
-void OBJLoader::ParseFace(const std::string &line,
-						  std::vector<uint32_t> &vertexIndices,
-						  std::vector<uint32_t> &uvIndices,
-						  std::vector<uint32_t> &normalIndices)
-{
-	std::istringstream iss(line);
-	std::string type;
-	iss >> type;
-
-	std::string vertex;
-	while (iss >> vertex)
-	{
-		std::replace(vertex.begin(), vertex.end(), '/', ' ');
-		std::istringstream vertexStream(vertex);
-		uint32_t v, vt, vn;
-		vertexStream >> v >> vt >> vn;
-
-		// OBJ indices are 1-based, convert to 0-based
-		vertexIndices.push_back(v - 1);
-		uvIndices.push_back(vt - 1);
-		normalIndices.push_back(vn - 1);
-	}
-}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "Engine/Loader/Texture/BlockCompression.h"
+
+#include <algorithm>
+
+namespace
+{
+	// Color blocks store two 565 endpoints followed by one byte of 2-bit indices per row
+	void FlipColorBlock(uint8_t *block, int rows)
+	{
+		std::reverse(block + 4, block + 4 + rows);
+	}
+
+	// Single channel blocks store two 8-bit endpoints followed by 12 bits of 3-bit indices per row
+	void FlipChannelBlock(uint8_t *block, int rows)
+	{
+		uint64_t bits = 0;
+		for (int i = 0; i < 6; i++)
+			bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+
+		uint64_t flipped = bits;
+		for (int row = 0; row < rows; row++)
+		{
+			int target = rows - 1 - row;
+			flipped &= ~(0xFFFull << (12 * target));
+			flipped |= ((bits >> (12 * row)) & 0xFFF) << (12 * target);
+		}
+
+		for (int i = 0; i < 6; i++)
+			block[2 + i] = static_cast<uint8_t>(flipped >> (8 * i));
+	}
+}
+
+size_t BlockCompression::GetBlockSize(GLenum format)
+{
+	switch (format)
+	{
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		return 8;
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+	case GL_COMPRESSED_RG_RGTC2:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+int BlockCompression::GetChannels(GLenum format)
+{
+	switch (format)
+	{
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		return 3;
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		return 4;
+	case GL_COMPRESSED_RG_RGTC2:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+size_t BlockCompression::GetLevelSize(GLenum format, int width, int height)
+{
+	size_t blocksX = std::max(1, (width + kBlockDimension - 1) / kBlockDimension);
+	size_t blocksY = std::max(1, (height + kBlockDimension - 1) / kBlockDimension);
+	return blocksX * blocksY * GetBlockSize(format);
+}
+
+bool BlockCompression::FlipVertically(GLenum format, uint8_t *data, int width, int height)
+{
+	size_t blockSize = GetBlockSize(format);
+	if (blockSize == 0 || (height > kBlockDimension && height % kBlockDimension != 0))
+	{
+		return false;
+	}
+
+	size_t blocksX = std::max(1, (width + kBlockDimension - 1) / kBlockDimension);
+	size_t blocksY = std::max(1, (height + kBlockDimension - 1) / kBlockDimension);
+	size_t rowSize = blocksX * blockSize;
+	for (size_t y = 0; y < blocksY / 2; y++)
+	{
+		std::swap_ranges(data + y * rowSize, data + (y + 1) * rowSize, data + (blocksY - 1 - y) * rowSize);
+	}
+
+	// Rows of a block below the image edge are padding and stay where they are
+	int rows = std::min(height, kBlockDimension);
+	for (size_t i = 0; i < blocksX * blocksY; i++)
+	{
+		uint8_t *block = data + i * blockSize;
+		switch (format)
+		{
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+			FlipColorBlock(block, rows);
+			break;
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			FlipChannelBlock(block, rows);
+			FlipColorBlock(block + 8, rows);
+			break;
+		case GL_COMPRESSED_RG_RGTC2:
+			FlipChannelBlock(block, rows);
+			FlipChannelBlock(block + 8, rows);
+			break;
+		}
+	}
+	return true;
+}
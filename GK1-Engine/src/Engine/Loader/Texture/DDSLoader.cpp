@@ -0,0 +1,182 @@
+#include "Engine/Loader/Texture/DDSLoader.h"
+#include "Engine/Loader/Texture/BlockCompression.h"
+#include "Engine/FileSystem.h"
+#include "Engine/Profiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+	{
+		return uint32_t(uint8_t(a)) | uint32_t(uint8_t(b)) << 8 | uint32_t(uint8_t(c)) << 16 | uint32_t(uint8_t(d)) << 24;
+	}
+
+	constexpr uint32_t kMagic = MakeFourCC('D', 'D', 'S', ' ');
+	constexpr uint32_t kFlagMipMapCount = 0x20000;
+	constexpr uint32_t kPixelFormatFourCC = 0x4;
+	constexpr uint32_t kCaps2Cubemap = 0x200;
+
+	// DXGI_FORMAT values of the extended header
+	constexpr uint32_t kDxgiBC1 = 71;
+	constexpr uint32_t kDxgiBC1Srgb = 72;
+	constexpr uint32_t kDxgiBC3 = 77;
+	constexpr uint32_t kDxgiBC3Srgb = 78;
+	constexpr uint32_t kDxgiBC5 = 83;
+
+	struct PixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t bitCount;
+		uint32_t masks[4];
+	};
+
+	struct Header
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		PixelFormat pixelFormat;
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+	};
+
+	struct HeaderDX10
+	{
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+
+	GLenum GetFormat(const Header &header, const HeaderDX10 *extended)
+	{
+		if (extended)
+		{
+			switch (extended->dxgiFormat)
+			{
+			case kDxgiBC1:
+			case kDxgiBC1Srgb:
+				return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			case kDxgiBC3:
+			case kDxgiBC3Srgb:
+				return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case kDxgiBC5:
+				return GL_COMPRESSED_RG_RGTC2;
+			default:
+				return 0;
+			}
+		}
+
+		if (!(header.pixelFormat.flags & kPixelFormatFourCC)) return 0;
+		switch (header.pixelFormat.fourCC)
+		{
+		case MakeFourCC('D', 'X', 'T', '1'):
+			return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case MakeFourCC('D', 'X', 'T', '5'):
+			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case MakeFourCC('A', 'T', 'I', '2'):
+		case MakeFourCC('B', 'C', '5', 'U'):
+			return GL_COMPRESSED_RG_RGTC2;
+		default:
+			return 0;
+		}
+	}
+}
+
+bool DDSLoader::Load(const std::string &filePath, Texture::Image &image, bool flipVertically)
+{
+	PROFILE_SCOPE("DDSLoader::Load");
+
+	FileData file;
+	if (!FileSystem::Read(filePath, file))
+	{
+		std::cerr << "Failed to open DDS file: " << filePath << std::endl;
+		return false;
+	}
+
+	const char *data = file.GetData();
+	size_t offset = sizeof(uint32_t) + sizeof(Header);
+	uint32_t magic;
+	Header header;
+	if (file.GetSize() < offset)
+	{
+		std::cerr << "Truncated DDS file: " << filePath << std::endl;
+		return false;
+	}
+	std::memcpy(&magic, data, sizeof(magic));
+	std::memcpy(&header, data + sizeof(magic), sizeof(header));
+	if (magic != kMagic || header.size != sizeof(Header))
+	{
+		std::cerr << "Not a DDS file: " << filePath << std::endl;
+		return false;
+	}
+
+	HeaderDX10 extended;
+	bool hasExtended = (header.pixelFormat.flags & kPixelFormatFourCC) && header.pixelFormat.fourCC == MakeFourCC('D', 'X', '1', '0');
+	if (hasExtended)
+	{
+		if (file.GetSize() < offset + sizeof(extended))
+		{
+			std::cerr << "Truncated DDS file: " << filePath << std::endl;
+			return false;
+		}
+		std::memcpy(&extended, data + offset, sizeof(extended));
+		offset += sizeof(extended);
+	}
+
+	GLenum format = GetFormat(header, hasExtended ? &extended : nullptr);
+	if (format == 0 || (header.caps2 & kCaps2Cubemap) || (hasExtended && extended.arraySize > 1) || header.width == 0 || header.height == 0)
+	{
+		std::cerr << "Unsupported DDS file, only 2D BC1, BC3 and BC5 textures are supported: " << filePath << std::endl;
+		return false;
+	}
+
+	image.width = static_cast<int>(header.width);
+	image.height = static_cast<int>(header.height);
+	image.channels = BlockCompression::GetChannels(format);
+	image.compressedFormat = format;
+
+	// Some writers leave the count at 0 for a single level, and a count past 1x1 would read garbage
+	uint32_t levelCount = (header.flags & kFlagMipMapCount) ? std::max(header.mipMapCount, 1u) : 1u;
+	size_t totalSize = 0;
+	image.levelSizes.clear();
+	for (uint32_t level = 0; level < levelCount; level++)
+	{
+		int width = std::max(1, image.width >> level);
+		int height = std::max(1, image.height >> level);
+		image.levelSizes.push_back(BlockCompression::GetLevelSize(format, width, height));
+		totalSize += image.levelSizes.back();
+		if (width == 1 && height == 1) break;
+	}
+
+	if (file.GetSize() - offset < totalSize)
+	{
+		std::cerr << "Truncated DDS file: " << filePath << std::endl;
+		return false;
+	}
+
+	image.pixels.reset(static_cast<uint8_t *>(std::malloc(totalSize)));
+	std::memcpy(image.pixels.get(), data + offset, totalSize);
+
+	if (flipVertically && !FlipLevels(image))
+	{
+		std::cerr << "DDS file cannot be flipped, its height is not a multiple of 4: " << filePath << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,165 @@
+#include "Engine/Loader/Texture/KTX2Loader.h"
+#include "Engine/Loader/Texture/BlockCompression.h"
+#include "Engine/FileSystem.h"
+#include "Engine/Profiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	// Finds the KTXorientation entry in the key/value data, files without one are stored top to bottom
+	bool IsBottomUp(std::string_view keyValueData)
+	{
+		constexpr std::string_view kKey = "KTXorientation";
+		size_t offset = 0;
+		while (keyValueData.size() - offset >= sizeof(uint32_t))
+		{
+			uint32_t length;
+			std::memcpy(&length, keyValueData.data() + offset, sizeof(length));
+			offset += sizeof(length);
+			if (keyValueData.size() - offset < length) break;
+
+			// Key and value are both null terminated
+			std::string_view entry = keyValueData.substr(offset, length);
+			size_t separator = entry.find('\0');
+			if (separator != std::string_view::npos && entry.substr(0, separator) == kKey)
+			{
+				std::string_view value = entry.substr(separator + 1);
+				return value.size() >= 2 && value[1] == 'u';
+			}
+
+			offset += (length + 3) & ~size_t(3);
+		}
+		return false;
+	}
+}
+
+GLenum KTX2Loader::GetGLFormat(uint32_t vkFormat)
+{
+	switch (vkFormat)
+	{
+	case kFormatBC1:
+	case kFormatBC1Srgb:
+		return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case kFormatBC3:
+	case kFormatBC3Srgb:
+		return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case kFormatBC5:
+		return GL_COMPRESSED_RG_RGTC2;
+	default:
+		return 0;
+	}
+}
+
+int KTX2Loader::GetPixelChannels(uint32_t vkFormat)
+{
+	switch (vkFormat)
+	{
+	case kFormatR8:
+		return 1;
+	case kFormatRG8:
+		return 2;
+	case kFormatRGB8:
+		return 3;
+	case kFormatRGBA8:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+bool KTX2Loader::Load(const std::string &filePath, Texture::Image &image, bool flipVertically)
+{
+	PROFILE_SCOPE("KTX2Loader::Load");
+
+	FileData file;
+	if (!FileSystem::Read(filePath, file))
+	{
+		std::cerr << "Failed to open KTX2 file: " << filePath << std::endl;
+		return false;
+	}
+
+	std::string_view data = file.GetView();
+	Header header;
+	if (data.size() < sizeof(Header))
+	{
+		std::cerr << "Truncated KTX2 file: " << filePath << std::endl;
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (std::memcmp(header.identifier, kIdentifier, sizeof(kIdentifier)) != 0)
+	{
+		std::cerr << "Not a KTX2 file: " << filePath << std::endl;
+		return false;
+	}
+
+	GLenum format = GetGLFormat(header.vkFormat);
+	int pixelChannels = GetPixelChannels(header.vkFormat);
+	// Arrays are only supported as cubemap arrays
+	bool cubemap = header.faceCount == 6;
+	if ((format == 0 && pixelChannels == 0) || header.supercompressionScheme != 0 || header.pixelDepth > 1
+		|| (header.faceCount != 1 && !cubemap) || (header.layerCount > 1 && !cubemap) || header.pixelWidth == 0 || header.pixelHeight == 0)
+	{
+		std::cerr << "Unsupported KTX2 file, only 2D and cubemap (array) BC1, BC3, BC5 and 8-bit UNORM textures without supercompression are supported: "
+			<< filePath << std::endl;
+		return false;
+	}
+
+	// A level count of 0 asks the loader to generate mips, Texture::Upload does that for pixel formats
+	uint32_t levelCount = std::max(header.levelCount, 1u);
+	if ((data.size() - sizeof(Header)) / sizeof(LevelIndex) < levelCount)
+	{
+		std::cerr << "Truncated KTX2 file: " << filePath << std::endl;
+		return false;
+	}
+
+	image.width = static_cast<int>(header.pixelWidth);
+	image.height = static_cast<int>(header.pixelHeight);
+	image.channels = format != 0 ? BlockCompression::GetChannels(format) : pixelChannels;
+	image.layers = static_cast<int>(header.faceCount * std::max(header.layerCount, 1u));
+	image.compressedFormat = format;
+	image.levelSizes.clear();
+
+	std::vector<LevelIndex> levels(levelCount);
+	std::memcpy(levels.data(), data.data() + sizeof(Header), levelCount * sizeof(LevelIndex));
+
+	size_t totalSize = 0;
+	for (uint32_t level = 0; level < levelCount; level++)
+	{
+		int width = std::max(1, image.width >> level);
+		int height = std::max(1, image.height >> level);
+		// Layers and faces of a level are packed without padding
+		size_t size = format != 0 ? BlockCompression::GetLevelSize(format, width, height) : static_cast<size_t>(width) * height * pixelChannels;
+		size *= image.layers;
+		if (levels[level].byteLength != size || levels[level].byteOffset > data.size() || data.size() - levels[level].byteOffset < size)
+		{
+			std::cerr << "Corrupt KTX2 level " << level << " in " << filePath << std::endl;
+			return false;
+		}
+		image.levelSizes.push_back(size);
+		totalSize += size;
+	}
+
+	// Levels are stored smallest first in the file, the image keeps the base level first
+	image.pixels.reset(static_cast<uint8_t *>(std::malloc(totalSize)));
+	uint8_t *destination = image.pixels.get();
+	for (uint32_t level = 0; level < levelCount; level++)
+	{
+		std::memcpy(destination, data.data() + levels[level].byteOffset, image.levelSizes[level]);
+		destination += image.levelSizes[level];
+	}
+
+	bool bottomUp = header.kvdByteLength > 0 && header.kvdByteOffset <= data.size() && data.size() - header.kvdByteOffset >= header.kvdByteLength
+		&& IsBottomUp(data.substr(header.kvdByteOffset, header.kvdByteLength));
+	if (flipVertically != bottomUp && !FlipLevels(image))
+	{
+		std::cerr << "KTX2 file cannot be flipped, its height is not a multiple of 4: " << filePath << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,35 @@
+#include "Engine/Loader/Texture/TextureLoader.h"
+#include "Engine/Loader/Texture/BlockCompression.h"
+
+#include <algorithm>
+
+bool TextureLoader::FlipLevels(Texture::Image &image)
+{
+	uint8_t *level = image.pixels.get();
+	for (size_t i = 0; i < image.levelSizes.size(); i++)
+	{
+		int width = std::max(1, image.width >> i);
+		int height = std::max(1, image.height >> i);
+		// Every layer is flipped on its own
+		size_t layerSize = image.levelSizes[i] / image.layers;
+		for (int layer = 0; layer < image.layers; layer++)
+		{
+			uint8_t *pixels = level + layer * layerSize;
+			if (image.compressedFormat == 0)
+			{
+				size_t rowSize = layerSize / height;
+				for (int y = 0; y < height / 2; y++)
+					std::swap_ranges(pixels + y * rowSize, pixels + (y + 1) * rowSize, pixels + (height - 1 - y) * rowSize);
+			}
+			else if (!BlockCompression::FlipVertically(image.compressedFormat, pixels, width, height))
+			{
+				// Heights are the same for every layer, so this can only fail on the first one
+				if (i == 0) return false;
+				image.levelSizes.resize(i);
+				return true;
+			}
+		}
+		level += image.levelSizes[i];
+	}
+	return true;
+}
@@ -0,0 +1,143 @@
+#include "Engine/MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+	*this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+		m_isOpen = std::exchange(other.m_isOpen, false);
+#ifdef _WIN32
+		m_file = std::exchange(other.m_file, nullptr);
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+	}
+	return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string &path)
+{
+	Close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	m_file = file;
+	m_size = static_cast<size_t>(size.QuadPart);
+	m_isOpen = true;
+
+	// Empty files cannot be mapped
+	if (m_size == 0)
+		return true;
+
+	m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping)
+		m_data = static_cast<const char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (!m_data)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	if (m_file)
+		CloseHandle(m_file);
+
+	m_data = nullptr;
+	m_mapping = nullptr;
+	m_file = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string &path)
+{
+	Close();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	m_size = static_cast<size_t>(info.st_size);
+	m_isOpen = true;
+
+	if (m_size > 0)
+	{
+		void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+		{
+			close(fd);
+			m_size = 0;
+			m_isOpen = false;
+			return false;
+		}
+		madvise(data, m_size, MADV_SEQUENTIAL);
+		m_data = static_cast<const char *>(data);
+	}
+
+	// The mapping keeps its own reference to the file
+	close(fd);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data)
+		munmap(const_cast<char *>(m_data), m_size);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+}
+
+#endif
@@ -0,0 +1,371 @@
+#include "Engine/NullGL.h"
+#include "Engine/Log.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Generic stubs are called through pointers of other signatures and ignore their arguments,
+// which is only safe with caller-cleanup calling conventions
+#if defined(_WIN32) && !defined(_WIN64)
+#error "NullGL requires a 64-bit build"
+#endif
+
+bool NullGL::s_loaded = false;
+
+namespace
+{
+	std::vector<std::string> s_names;
+	std::unordered_map<std::string, size_t> s_slots;
+
+	std::array<uint64_t, NullGL::kMaxFunctions> s_frameCounts{};
+	std::array<uint64_t, NullGL::kMaxFunctions> s_lastFrame{};
+	std::array<uint64_t, NullGL::kMaxFunctions> s_totals{};
+	uint64_t s_frames = 0;
+
+	GLuint s_nextName = 1;
+	std::vector<uint8_t> s_mapScratch;
+	constexpr size_t kMapBufferScratch = 64 * 1024 * 1024;
+
+	// Entry points that must write outputs or return something other than zero
+#define NULLGL_OVERRIDES(X) \
+	X(glGetString, GetString) \
+	X(glGetStringi, GetStringi) \
+	X(glGetIntegerv, GetIntegerv) \
+	X(glGetShaderiv, GetObjectiv) \
+	X(glGetProgramiv, GetObjectiv) \
+	X(glGetQueryObjectiv, GetObjectiv) \
+	X(glGetQueryObjectuiv, GetObjectiv) \
+	X(glGetQueryObjecti64v, GetObject64v) \
+	X(glGetQueryObjectui64v, GetObject64v) \
+	X(glGetShaderInfoLog, GetInfoLog) \
+	X(glGetProgramInfoLog, GetInfoLog) \
+	X(glGenBuffers, GenNames) \
+	X(glGenVertexArrays, GenNames) \
+	X(glGenTextures, GenNames) \
+	X(glGenFramebuffers, GenNames) \
+	X(glGenRenderbuffers, GenNames) \
+	X(glGenQueries, GenNames) \
+	X(glGenSamplers, GenNames) \
+	X(glGenProgramPipelines, GenNames) \
+	X(glGenTransformFeedbacks, GenNames) \
+	X(glCreateBuffers, GenNames) \
+	X(glCreateVertexArrays, GenNames) \
+	X(glCreateFramebuffers, GenNames) \
+	X(glCreateRenderbuffers, GenNames) \
+	X(glCreateSamplers, GenNames) \
+	X(glCreateProgramPipelines, GenNames) \
+	X(glCreateTransformFeedbacks, GenNames) \
+	X(glCreateTextures, CreateNames) \
+	X(glCreateQueries, CreateNames) \
+	X(glCreateProgram, CreateProgram) \
+	X(glCreateShader, CreateShader) \
+	X(glCheckFramebufferStatus, CheckFramebufferStatus) \
+	X(glCheckNamedFramebufferStatus, CheckNamedFramebufferStatus) \
+	X(glMapBuffer, MapBuffer) \
+	X(glMapNamedBuffer, MapBuffer) \
+	X(glMapBufferRange, MapBufferRange) \
+	X(glMapNamedBufferRange, MapBufferRange) \
+	X(glUnmapBuffer, UnmapBuffer) \
+	X(glUnmapNamedBuffer, UnmapBuffer) \
+	X(glFenceSync, FenceSync) \
+	X(glClientWaitSync, ClientWaitSync)
+
+	enum Override
+	{
+#define X(name, stub) k_##name,
+		NULLGL_OVERRIDES(X)
+#undef X
+		kOverrideCount
+	};
+
+	std::array<size_t, kOverrideCount> s_overrideSlots{};
+
+	template <Override Id>
+	void Count()
+	{
+		s_frameCounts[s_overrideSlots[Id]]++;
+	}
+
+	template <size_t Slot>
+	uintptr_t GLAD_API_PTR GenericStub()
+	{
+		s_frameCounts[Slot]++;
+		return 0;
+	}
+
+	template <size_t... Slots>
+	std::array<GLADapiproc, sizeof...(Slots)> MakeGenericStubs(std::index_sequence<Slots...>)
+	{
+		return { reinterpret_cast<GLADapiproc>(&GenericStub<Slots>)... };
+	}
+
+	template <Override Id>
+	const GLubyte *GLAD_API_PTR GetString(GLenum name)
+	{
+		Count<Id>();
+		switch (name)
+		{
+			case GL_VENDOR: return reinterpret_cast<const GLubyte *>("GK1");
+			case GL_RENDERER: return reinterpret_cast<const GLubyte *>("NullGL");
+			case GL_VERSION: return reinterpret_cast<const GLubyte *>("4.6.0 NullGL");
+			case GL_SHADING_LANGUAGE_VERSION: return reinterpret_cast<const GLubyte *>("4.60 NullGL");
+			default: return reinterpret_cast<const GLubyte *>("");
+		}
+	}
+
+	template <Override Id>
+	const GLubyte *GLAD_API_PTR GetStringi(GLenum, GLuint)
+	{
+		Count<Id>();
+		return reinterpret_cast<const GLubyte *>("");
+	}
+
+	template <Override Id>
+	void GLAD_API_PTR GetIntegerv(GLenum pname, GLint *data)
+	{
+		Count<Id>();
+		switch (pname)
+		{
+			case GL_MAJOR_VERSION: data[0] = 4; break;
+			case GL_MINOR_VERSION: data[0] = 6; break;
+			case GL_VIEWPORT:
+			case GL_SCISSOR_BOX:
+				data[0] = data[1] = data[2] = data[3] = 0;
+				break;
+			case GL_POLYGON_MODE:
+				data[0] = data[1] = GL_FILL;
+				break;
+			default:
+				data[0] = 0;
+				break;
+		}
+	}
+
+	template <Override Id>
+	void GLAD_API_PTR GetObjectiv(GLuint, GLenum pname, GLint *params)
+	{
+		Count<Id>();
+		switch (pname)
+		{
+			case GL_COMPILE_STATUS:
+			case GL_LINK_STATUS:
+			case GL_VALIDATE_STATUS:
+			case GL_QUERY_RESULT_AVAILABLE:
+				*params = GL_TRUE;
+				break;
+			default:
+				*params = 0;
+				break;
+		}
+	}
+
+	template <Override Id>
+	void GLAD_API_PTR GetObject64v(GLuint, GLenum, GLuint64 *params)
+	{
+		Count<Id>();
+		*params = 0;
+	}
+
+	template <Override Id>
+	void GLAD_API_PTR GetInfoLog(GLuint, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+	{
+		Count<Id>();
+		if (length) *length = 0;
+		if (infoLog && bufSize > 0) infoLog[0] = '\0';
+	}
+
+	template <Override Id>
+	void GLAD_API_PTR GenNames(GLsizei n, GLuint *names)
+	{
+		Count<Id>();
+		for (GLsizei i = 0; i < n; i++)
+			names[i] = s_nextName++;
+	}
+
+	template <Override Id>
+	void GLAD_API_PTR CreateNames(GLenum, GLsizei n, GLuint *names)
+	{
+		Count<Id>();
+		for (GLsizei i = 0; i < n; i++)
+			names[i] = s_nextName++;
+	}
+
+	template <Override Id>
+	GLuint GLAD_API_PTR CreateProgram()
+	{
+		Count<Id>();
+		return s_nextName++;
+	}
+
+	template <Override Id>
+	GLuint GLAD_API_PTR CreateShader(GLenum)
+	{
+		Count<Id>();
+		return s_nextName++;
+	}
+
+	template <Override Id>
+	GLenum GLAD_API_PTR CheckFramebufferStatus(GLenum)
+	{
+		Count<Id>();
+		return GL_FRAMEBUFFER_COMPLETE;
+	}
+
+	template <Override Id>
+	GLenum GLAD_API_PTR CheckNamedFramebufferStatus(GLuint, GLenum)
+	{
+		Count<Id>();
+		return GL_FRAMEBUFFER_COMPLETE;
+	}
+
+	template <Override Id>
+	void *GLAD_API_PTR MapBuffer(GLuint, GLenum)
+	{
+		Count<Id>();
+		// The buffer size is unknown here, hand out a scratch block large enough for any upload we do
+		if (s_mapScratch.size() < kMapBufferScratch)
+			s_mapScratch.resize(kMapBufferScratch);
+		return s_mapScratch.data();
+	}
+
+	template <Override Id>
+	void *GLAD_API_PTR MapBufferRange(GLuint, GLintptr, GLsizeiptr length, GLbitfield)
+	{
+		Count<Id>();
+		if (s_mapScratch.size() < static_cast<size_t>(length))
+			s_mapScratch.resize(length);
+		return s_mapScratch.data();
+	}
+
+	template <Override Id>
+	GLboolean GLAD_API_PTR UnmapBuffer(GLuint)
+	{
+		Count<Id>();
+		return GL_TRUE;
+	}
+
+	template <Override Id>
+	GLsync GLAD_API_PTR FenceSync(GLenum, GLbitfield)
+	{
+		Count<Id>();
+		return reinterpret_cast<GLsync>(static_cast<uintptr_t>(s_nextName++));
+	}
+
+	template <Override Id>
+	GLenum GLAD_API_PTR ClientWaitSync(GLsync, GLbitfield, GLuint64)
+	{
+		Count<Id>();
+		return GL_ALREADY_SIGNALED;
+	}
+
+	struct OverrideEntry
+	{
+		const char *name;
+		Override id;
+		GLADapiproc proc;
+	};
+
+	const OverrideEntry kOverrides[] = {
+#define X(name, stub) { #name, k_##name, reinterpret_cast<GLADapiproc>(&stub<k_##name>) },
+		NULLGL_OVERRIDES(X)
+#undef X
+	};
+
+	std::vector<NullGL::Call> MakeHistogram(const std::array<uint64_t, NullGL::kMaxFunctions> &counts, double scale)
+	{
+		std::vector<NullGL::Call> calls;
+		for (size_t slot = 0; slot < s_names.size(); slot++)
+		{
+			if (counts[slot] > 0)
+				calls.push_back({ s_names[slot].c_str(), counts[slot] * scale });
+		}
+
+		std::sort(calls.begin(), calls.end(), [](const NullGL::Call &a, const NullGL::Call &b)
+			{
+				return a.count > b.count;
+			});
+		return calls;
+	}
+}
+
+bool NullGL::Load()
+{
+	s_loaded = gladLoadGL(GetProcAddress) != 0;
+
+	// Do not report the version queries made by the loader itself
+	s_frameCounts.fill(0);
+	ResetTotals();
+	return s_loaded;
+}
+
+GLADapiproc NullGL::GetProcAddress(const char *name)
+{
+	static const auto genericStubs = MakeGenericStubs(std::make_index_sequence<kMaxFunctions>());
+
+	auto it = s_slots.find(name);
+	size_t slot;
+	if (it != s_slots.end())
+	{
+		slot = it->second;
+	}
+	else
+	{
+		if (s_names.size() == kMaxFunctions)
+		{
+			Log::Error(std::string("NullGL: out of stubs for ") + name);
+			return nullptr;
+		}
+		slot = s_names.size();
+		s_names.push_back(name);
+		s_slots.emplace(name, slot);
+	}
+
+	for (const auto &entry : kOverrides)
+	{
+		if (s_names[slot] == entry.name)
+		{
+			s_overrideSlots[entry.id] = slot;
+			return entry.proc;
+		}
+	}
+	return genericStubs[slot];
+}
+
+void NullGL::EndFrame()
+{
+	for (size_t slot = 0; slot < s_names.size(); slot++)
+	{
+		s_lastFrame[slot] = s_frameCounts[slot];
+		s_totals[slot] += s_frameCounts[slot];
+		s_frameCounts[slot] = 0;
+	}
+	s_frames++;
+}
+
+void NullGL::ResetTotals()
+{
+	s_lastFrame.fill(0);
+	s_totals.fill(0);
+	s_frames = 0;
+}
+
+std::vector<NullGL::Call> NullGL::GetFrameHistogram()
+{
+	return MakeHistogram(s_lastFrame, 1.0);
+}
+
+std::vector<NullGL::Call> NullGL::GetAverageHistogram()
+{
+	return MakeHistogram(s_totals, s_frames > 0 ? 1.0 / s_frames : 0.0);
+}
+
+uint64_t NullGL::GetFrameCallCount()
+{
+	uint64_t total = 0;
+	for (size_t slot = 0; slot < s_names.size(); slot++)
+		total += s_lastFrame[slot];
+	return total;
+}
@@ -1,4 +1,5 @@
 #include "Engine/Objects/Light/LightManager.h"
+#include "Engine/RenderStats.h"
 #include <glad/gl.h>
 
 LightManager::LightManager()
@@ -74,6 +75,7 @@ void LightManager::UpdateLights() {
 	glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
 	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightBuffer), &lightBuffer);
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	RenderStats::AddBufferUpload(sizeof(LightBuffer));
 
 	glBindBufferBase(GL_UNIFORM_BUFFER, 1, m_ubo);
 }
@@ -1,4 +1,5 @@
 #include "Engine/Objects/Mesh.h"
+#include "Engine/RenderStats.h"
 
 Mesh::Mesh() : geometry(nullptr), material(nullptr)
 {
@@ -18,10 +19,11 @@ void Mesh::Draw()
 	if (!geometry || !material) return;
 
 	material->Bind();
-	glBindVertexArray(geometry->GetVAO());
+	geometry->Bind();
 	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(geometry->GetIndexCount()), GL_UNSIGNED_INT, 0);
+	RenderStats::AddDraw(GL_TRIANGLES, geometry->GetIndexCount() / 3);
+	// The next draw binds its own program and textures, unbinding the material here would only double the state changes
 	glBindVertexArray(0);
-	material->Unbind();
 }
 
 glm::vec3 Mesh::GetMinBounds() const
@@ -1,6 +1,10 @@
 #include "Engine/Objects/Model.h"
 #include "Engine/Loader/LoaderFactory.h"
+#include "Engine/Loader/Model/ModelCache.h"
 #include "Engine/Loader/Model/ModelLoader.h"
+#include "Engine/Profiler.h"
+#include "Engine/ResourceManager.h"
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 
@@ -14,6 +18,25 @@ Model::~Model()
 
 std::shared_ptr<Model> Model::LoadFromFile(const std::string &path)
 {
+	ModelData data;
+	if (!LoadData(path, data))
+	{
+		return nullptr;
+	}
+
+	auto model = std::make_shared<Model>();
+	model->Build(data);
+	return model;
+}
+
+bool Model::LoadData(const std::string &path, ModelData &data)
+{
+	// Cooked copy from an earlier run, skips parsing and vertex processing
+	if (ModelCache::Load(path, data))
+	{
+		return true;
+	}
+
 	// Get file extension
 	std::string extension = std::filesystem::path(path).extension().string();
 
@@ -22,17 +45,54 @@ std::shared_ptr<Model> Model::LoadFromFile(const std::string &path)
 	if (!factory)
 	{
 		std::cerr << "Failed to find loader for extension: " << extension << std::endl;
-		return nullptr;
+		return false;
 	}
 
-	auto model = factory->Load(path);
-	if (!model)
+	data = ModelData();
+	if (!factory->Load(path, data))
 	{
 		std::cerr << "Failed to load model: " << path << std::endl;
-		return nullptr;
+		return false;
 	}
 
-	return model;
+	if (!ModelCache::Write(path, data))
+	{
+		std::cerr << "Failed to write cooked model: " << ModelCache::GetCachePath(path) << std::endl;
+	}
+
+	return true;
+}
+
+void Model::Build(const ModelData &data)
+{
+	PROFILE_SCOPE("Model::Build");
+
+	m_meshes.clear();
+	m_materialLibraries = data.materialLibraries;
+
+	// Usually finished already by a load graph node this model depended on
+	std::vector<std::shared_ptr<Material>> materials;
+	for (const auto &library : data.materialLibraries)
+	{
+		auto loaded = ResourceManager::Get().LoadMaterialLibrary(library);
+		materials.insert(materials.end(), loaded.begin(), loaded.end());
+	}
+
+	for (const auto &meshData : data.meshes)
+	{
+		Mesh mesh;
+		mesh.geometry = std::make_shared<Geometry>(meshData.GetVertices(), meshData.GetIndices());
+		mesh.SetName(meshData.name);
+
+		auto it = std::find_if(materials.begin(), materials.end(),
+			[&meshData](std::shared_ptr<Material> material)
+			{
+				return material->GetName() == meshData.material;
+			});
+		mesh.material = !meshData.material.empty() && it != materials.end() ? *it : std::make_shared<Material>();
+
+		AddMesh(mesh);
+	}
 }
 
 void Model::Draw()
@@ -1,4 +1,5 @@
 #include "Engine/Objects/SceneNode.h"
+#include "Engine/Profiler.h"
 
 SceneNode::SceneNode(std::shared_ptr<GraphicsObject> obj)
 	: m_parent(nullptr), m_obj(obj)
@@ -33,6 +34,8 @@ glm::mat4 SceneNode::GetWorldMatrix() const
 
 void SceneNode::Draw()
 {
+	PROFILE_SCOPE("SceneNode::Draw");
+
 	if (m_obj)
 	{
 		m_obj->SetWorldMatrix(GetWorldMatrix());
@@ -1,4 +1,6 @@
 #include "Engine/Objects/Skybox.h"
+#include "Engine/RenderStats.h"
+#include "Engine/ResourceManager.h"
 
 // Skybox vertices - a cube centered at origin
 static constexpr float kSkyboxVertices[] = {         
@@ -103,13 +105,53 @@ void main()
 }
 )";
 
+// Same blend with both skies in one cubemap array, layer 0 is day and layer 1 night
+static constexpr char kSkyboxArrayFragmentShader[] = R"(
+#version 400 core
+out vec4 FragColor;
+
+in vec3 TexCoords;
+
+uniform samplerCubeArray skybox;
+uniform float blendFactor;
+uniform int hasNight;
+
+layout (std140) uniform Fog
+{
+	vec4 color; // intensity in w
+	int enabled;
+} fog;
+
+void main()
+{
+	vec3 color = texture(skybox, vec4(TexCoords, 0.0)).rgb;
+
+	if (hasNight != 0)
+	{
+		vec3 night = texture(skybox, vec4(TexCoords, 1.0)).rgb;
+		color = mix(night, color, blendFactor);
+	}
+
+	if (fog.enabled != 0)
+	{
+		color = fog.color.rgb;
+	}
+
+	FragColor = vec4(color, 1.0);
+}
+)";
+
 
 Skybox::Skybox() : m_vao(0), m_vbo(0)
 {
 	SetupGeometry();
-	m_shader = Shader::LoadFromString(kSkyboxVertexShader, kSkyboxFragmentShader);
+	auto &shaderCache = ResourceManager::Get().GetShaderCache();
+	m_shader = shaderCache.Load(kSkyboxVertexShader, kSkyboxFragmentShader);
 	m_shader->BindUBO("Matrices", 0);
 	m_shader->BindUBO("Fog", 2);
+	m_arrayShader = shaderCache.Load(kSkyboxVertexShader, kSkyboxArrayFragmentShader);
+	m_arrayShader->BindUBO("Matrices", 0);
+	m_arrayShader->BindUBO("Fog", 2);
 }
 
 Skybox::~Skybox()
@@ -133,7 +175,7 @@ void Skybox::Cleanup()
 
 std::shared_ptr<Skybox> Skybox::LoadFromCubemap(std::shared_ptr<Texture> cubemap)
 {
-	if (!cubemap || cubemap->GetType() != Texture::TextureType::Cubemap)
+	if (!cubemap || (cubemap->GetType() != Texture::TextureType::Cubemap && cubemap->GetType() != Texture::TextureType::CubemapArray))
 	{
 		return nullptr;
 	}
@@ -170,7 +212,8 @@ void Skybox::SetupGeometry()
 
 void Skybox::Draw()
 {
-	if (!m_shader || !m_dayCubemap) return;
+	// Async loads leave the clear color visible until the sky is uploaded
+	if (!m_shader || !m_dayCubemap || !m_dayCubemap->IsLoaded()) return;
 
 	// Store current OpenGL state
 	GLint oldCullFaceMode;
@@ -182,19 +225,31 @@ void Skybox::Draw()
 	glDepthFunc(GL_LEQUAL);
 
 	int kSlot = 0;
-	m_shader->Use();
-	m_dayCubemap->Bind(kSlot);
-	m_shader->SetInt("skyboxDay", kSlot);
-	m_shader->SetInt("hasNight", m_nightCubemap ? 1 : 0);
-	if (m_nightCubemap)
+	if (m_dayCubemap->GetType() == Texture::TextureType::CubemapArray)
+	{
+		m_arrayShader->Use();
+		m_dayCubemap->Bind(kSlot);
+		m_arrayShader->SetInt("skybox", kSlot);
+		m_arrayShader->SetInt("hasNight", m_dayCubemap->GetLayerCount() > 1 ? 1 : 0);
+		m_arrayShader->SetFloat("blendFactor", m_blendFactor);
+	}
+	else
 	{
-		m_nightCubemap->Bind(++kSlot);
-		m_shader->SetInt("skyboxNight", kSlot);
-		m_shader->SetFloat("blendFactor", m_blendFactor);
+		m_shader->Use();
+		m_dayCubemap->Bind(kSlot);
+		m_shader->SetInt("skyboxDay", kSlot);
+		m_shader->SetInt("hasNight", m_nightCubemap ? 1 : 0);
+		if (m_nightCubemap)
+		{
+			m_nightCubemap->Bind(++kSlot);
+			m_shader->SetInt("skyboxNight", kSlot);
+			m_shader->SetFloat("blendFactor", m_blendFactor);
+		}
 	}
 
 	glBindVertexArray(m_vao);
 	glDrawArrays(GL_TRIANGLES, 0, 36);
+	RenderStats::AddDraw(GL_TRIANGLES, 12);
 	glBindVertexArray(0);
 
 	// Restore OpenGL state
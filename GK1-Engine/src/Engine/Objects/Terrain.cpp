@@ -1,4 +1,9 @@
 #include "Engine/Objects/Terrain.h"
+#include "Engine/GpuProfiler.h"
+#include "Engine/RenderStats.h"
+#include "Engine/ResourceManager.h"
+
+#include <iostream>
 
 static constexpr char vertexShaderSource[] = R"(
 #version 410 core
@@ -225,8 +230,10 @@ vec3 CalcLight(Light light, vec3 normal, vec3 fragPos, vec3 viewPos)
 
 void main()
 {
-	vec3 Normal = texture(material.normalMap0, fs_in.texCoords).rgb;
-	Normal = Normal * 2.0 - 1.0;   
+	// Z is rebuilt from X and Y so two-channel (BC5) normal maps work too
+	vec3 Normal;
+	Normal.xy = texture(material.normalMap0, fs_in.texCoords).rg * 2.0 - 1.0;
+	Normal.z = sqrt(max(1.0 - dot(Normal.xy, Normal.xy), 0.0));
 	Normal = normalize(fs_in.TBN * Normal); 
     
 	// Calculate lighting
@@ -262,12 +269,13 @@ Terrain::Terrain(uint32_t gridSize)
 	glGenBuffers(1, &m_ebo);
 
 	// Load terrain shaders
-	auto shader = std::make_shared<Shader>();
-	shader->AddShaderStage(Shader::ShaderType::Vertex, vertexShaderSource);
-	shader->AddShaderStage(Shader::ShaderType::TessControl, tessControlShaderSource);
-	shader->AddShaderStage(Shader::ShaderType::TessEvaluation, tessEvalShaderSource);
-	shader->AddShaderStage(Shader::ShaderType::Fragment, fragmentShaderSource);
-	shader->Link();
+	const ShaderCache::Stage stages[] = {
+		{ Shader::ShaderType::Vertex, vertexShaderSource },
+		{ Shader::ShaderType::TessControl, tessControlShaderSource },
+		{ Shader::ShaderType::TessEvaluation, tessEvalShaderSource },
+		{ Shader::ShaderType::Fragment, fragmentShaderSource },
+	};
+	auto shader = ResourceManager::Get().GetShaderCache().Load(stages);
 
 	m_material = std::make_shared<Material>(shader);
 }
@@ -280,6 +288,11 @@ Terrain::~Terrain()
 void Terrain::GenerateCollisionMesh(uint32_t gridSize, std::vector<glm::vec3> &vertices, std::vector<uint32_t> &indices)
 {
 	if (!m_heightmap) return;
+	if (!m_heightmap->HasCpuData())
+	{
+		std::cerr << "Terrain heightmap has no CPU copy, load it with Texture::Residency::KeepCpuCopy" << std::endl;
+		return;
+	}
 
 	float spacing = 1.0f / (gridSize - 1);
 	int width = m_heightmap->GetWidth();
@@ -378,6 +391,8 @@ void Terrain::SetupGeometry()
 void Terrain::Draw()
 {
 	if (!m_heightmap) return;
+	GPU_PROFILE_SCOPE("Terrain");
+
 	if (m_dirty)
 	{
 		SetupGeometry();
@@ -402,6 +417,7 @@ void Terrain::Draw()
 	glPatchParameteri(GL_PATCH_VERTICES, 4);
 	glBindVertexArray(m_vao);
 	glDrawElements(GL_PATCHES, (GLsizei)m_indices.size(), GL_UNSIGNED_INT, 0);
+	RenderStats::AddDraw(GL_PATCHES, m_indices.size() / 4);
 	glBindVertexArray(0);
 }
 
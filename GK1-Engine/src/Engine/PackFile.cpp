@@ -0,0 +1,75 @@
+#include "Engine/PackFile.h"
+
+#include <cstring>
+#include <iostream>
+
+bool PackFile::Open(const std::string &path)
+{
+	m_entries.clear();
+	m_path = path;
+	if (!m_file.Open(path))
+	{
+		std::cerr << "Failed to open pack " << path << std::endl;
+		return false;
+	}
+
+	const char *data = m_file.GetData();
+	size_t fileSize = m_file.GetSize();
+
+	Header header;
+	if (fileSize < sizeof(header))
+	{
+		std::cerr << "Pack " << path << " is truncated" << std::endl;
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion)
+	{
+		std::cerr << "Pack " << path << " has an unknown format or version" << std::endl;
+		return false;
+	}
+	if (header.indexOffset > fileSize || header.indexSize > fileSize - header.indexOffset)
+	{
+		std::cerr << "Pack " << path << " has an invalid index" << std::endl;
+		return false;
+	}
+
+	const char *index = data + header.indexOffset;
+	const char *indexEnd = index + header.indexSize;
+	m_entries.reserve(header.entryCount);
+	for (uint32_t i = 0; i < header.entryCount; i++)
+	{
+		IndexRecord record;
+		if (static_cast<size_t>(indexEnd - index) < sizeof(record))
+			break;
+		std::memcpy(&record, index, sizeof(record));
+		index += sizeof(record);
+
+		if (static_cast<size_t>(indexEnd - index) < record.pathLength ||
+			record.offset > header.indexOffset || record.storedSize > header.indexOffset - record.offset)
+			break;
+
+		m_entries.emplace(std::string(index, record.pathLength),
+			Entry{ record.offset, record.storedSize, record.size, record.time, record.compression });
+		index += record.pathLength;
+	}
+
+	if (m_entries.size() != header.entryCount)
+	{
+		std::cerr << "Pack " << path << " has a corrupt index" << std::endl;
+		m_entries.clear();
+		return false;
+	}
+	return true;
+}
+
+const PackFile::Entry *PackFile::Find(const std::string &path) const
+{
+	auto it = m_entries.find(path);
+	return it != m_entries.end() ? &it->second : nullptr;
+}
+
+std::string_view PackFile::GetStoredData(const Entry &entry) const
+{
+	return std::string_view(m_file.GetData() + entry.offset, entry.storedSize);
+}
@@ -0,0 +1,174 @@
+#include "Engine/Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct ThreadBuffer
+	{
+		std::mutex mutex;
+		uint32_t threadId = 0;
+		std::string name;
+		const char *category = "cpu";
+		std::vector<Profiler::Zone> startup;
+		std::vector<Profiler::Zone> ring;
+		size_t head = 0;
+		bool wrapped = false;
+	};
+
+	const auto s_epoch = std::chrono::steady_clock::now();
+	std::atomic<bool> s_capturingStartup{ true };
+
+	std::mutex s_registryMutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> s_registry;
+
+	ThreadBuffer &GetThreadBuffer()
+	{
+		// Buffers are owned by the registry so zones of finished threads still end up in the dump
+		thread_local std::shared_ptr<ThreadBuffer> buffer = []()
+			{
+				auto newBuffer = std::make_shared<ThreadBuffer>();
+				newBuffer->ring.resize(Profiler::kRingCapacity);
+
+				std::lock_guard<std::mutex> lock(s_registryMutex);
+				newBuffer->threadId = static_cast<uint32_t>(s_registry.size());
+				newBuffer->name = newBuffer->threadId == 0 ? "Main" : "Thread " + std::to_string(newBuffer->threadId);
+				s_registry.push_back(newBuffer);
+				return newBuffer;
+			}();
+		return *buffer;
+	}
+
+	ThreadBuffer &GetGpuBuffer()
+	{
+		// GPU zones are resolved frames later on the main thread, they get a track of their own
+		static std::shared_ptr<ThreadBuffer> buffer = []()
+			{
+				auto newBuffer = std::make_shared<ThreadBuffer>();
+				newBuffer->ring.resize(Profiler::kRingCapacity);
+				newBuffer->name = "GPU";
+				newBuffer->category = "gpu";
+
+				std::lock_guard<std::mutex> lock(s_registryMutex);
+				newBuffer->threadId = static_cast<uint32_t>(s_registry.size());
+				s_registry.push_back(newBuffer);
+				return newBuffer;
+			}();
+		return *buffer;
+	}
+
+	void Push(ThreadBuffer &buffer, const Profiler::Zone &zone)
+	{
+		std::lock_guard<std::mutex> lock(buffer.mutex);
+
+		if (s_capturingStartup.load(std::memory_order_relaxed))
+		{
+			buffer.startup.push_back(zone);
+			return;
+		}
+
+		buffer.ring[buffer.head] = zone;
+		if (++buffer.head == Profiler::kRingCapacity)
+		{
+			buffer.head = 0;
+			buffer.wrapped = true;
+		}
+	}
+
+	void WriteEscaped(std::ofstream &out, const char *str)
+	{
+		for (; *str; ++str)
+		{
+			if (*str == '"' || *str == '\\') out << '\\';
+			out << *str;
+		}
+	}
+
+	void WriteZone(std::ofstream &out, const Profiler::Zone &zone, const ThreadBuffer &buffer, bool &first)
+	{
+		out << (first ? "\n" : ",\n");
+		first = false;
+		out << "{\"name\":\"";
+		WriteEscaped(out, zone.name);
+		out << "\",\"cat\":\"" << buffer.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.threadId
+			<< ",\"ts\":" << zone.start / 1000.0 << ",\"dur\":" << zone.duration / 1000.0 << "}";
+	}
+}
+
+int64_t Profiler::Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+void Profiler::Record(const char *name, int64_t start, int64_t end)
+{
+	Push(GetThreadBuffer(), { name, start, end - start });
+}
+
+void Profiler::RecordGpu(const char *name, int64_t start, int64_t duration)
+{
+	Push(GetGpuBuffer(), { name, start, duration });
+}
+
+void Profiler::SetThreadName(const std::string &name)
+{
+	ThreadBuffer &buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	buffer.name = name;
+}
+
+void Profiler::EndStartup()
+{
+	s_capturingStartup.store(false, std::memory_order_relaxed);
+}
+
+bool Profiler::IsCapturingStartup()
+{
+	return s_capturingStartup.load(std::memory_order_relaxed);
+}
+
+bool Profiler::WriteChromeTrace(const std::string &path)
+{
+	std::ofstream out(path);
+	if (!out.is_open())
+		return false;
+
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	{
+		std::lock_guard<std::mutex> lock(s_registryMutex);
+		buffers = s_registry;
+	}
+
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+
+	for (const auto &buffer : buffers)
+	{
+		std::lock_guard<std::mutex> lock(buffer->mutex);
+
+		out << (first ? "\n" : ",\n");
+		first = false;
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":\"";
+		WriteEscaped(out, buffer->name.c_str());
+		out << "\"}}";
+
+		for (const auto &zone : buffer->startup)
+			WriteZone(out, zone, *buffer, first);
+
+		// Oldest entries first once the ring has wrapped
+		size_t count = buffer->wrapped ? kRingCapacity : buffer->head;
+		size_t begin = buffer->wrapped ? buffer->head : 0;
+		for (size_t i = 0; i < count; i++)
+			WriteZone(out, buffer->ring[(begin + i) % kRingCapacity], *buffer, first);
+	}
+
+	out << "\n]}\n";
+	return out.good();
+}
@@ -0,0 +1,50 @@
+#include "Engine/RenderStats.h"
+
+#include <algorithm>
+#include <iterator>
+
+RenderStats::Counters RenderStats::s_current;
+RenderStats::Counters RenderStats::s_last;
+GLuint RenderStats::s_lastProgram = 0;
+GLuint RenderStats::s_lastTextures[RenderStats::kTrackedSlots] = {};
+
+void RenderStats::AddDraw(GLenum mode, uint64_t primitives)
+{
+	s_current.drawCalls++;
+	if (mode == GL_PATCHES)
+		s_current.patches += primitives;
+	else
+		s_current.triangles += primitives;
+}
+
+void RenderStats::UseProgram(GLuint program)
+{
+	if (program != s_lastProgram)
+	{
+		s_current.programChanges++;
+		s_lastProgram = program;
+	}
+}
+
+void RenderStats::BindTexture(GLuint slot, GLuint texture)
+{
+	if (slot >= kTrackedSlots)
+	{
+		s_current.textureBinds++;
+		return;
+	}
+	if (texture != s_lastTextures[slot])
+	{
+		s_current.textureBinds++;
+		s_lastTextures[slot] = texture;
+	}
+}
+
+void RenderStats::EndFrame()
+{
+	s_last = s_current;
+	s_current = Counters();
+	// ImGui binds its own program outside of Shader::Use
+	s_lastProgram = 0;
+	std::fill(std::begin(s_lastTextures), std::end(s_lastTextures), 0);
+}
@@ -0,0 +1,94 @@
+#include "Engine/Resource/GpuMemory.h"
+#include "Engine/Profiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+std::vector<GpuResident *> GpuMemory::s_residents;
+size_t GpuMemory::s_budget = GpuMemory::kDefaultBudget;
+uint64_t GpuMemory::s_evictionAge = GpuMemory::kDefaultEvictionAge;
+uint64_t GpuMemory::s_frame = 0;
+size_t GpuMemory::s_bytes = 0;
+uint64_t GpuMemory::s_evictions = 0;
+uint64_t GpuMemory::s_restores = 0;
+bool GpuMemory::s_overBudget = false;
+
+GpuResident::GpuResident() : m_lastUsedFrame(GpuMemory::s_frame), m_index(GpuMemory::s_residents.size())
+{
+	GpuMemory::s_residents.push_back(this);
+}
+
+GpuResident::GpuResident(const GpuResident &) : GpuResident()
+{
+}
+
+GpuResident::~GpuResident()
+{
+	// Swap-remove, the moved object takes over the index
+	auto &residents = GpuMemory::s_residents;
+	residents[m_index] = residents.back();
+	residents[m_index]->m_index = m_index;
+	residents.pop_back();
+}
+
+void GpuResident::MarkUsed() const
+{
+	m_lastUsedFrame = GpuMemory::s_frame;
+}
+
+void GpuMemory::Update()
+{
+	PROFILE_SCOPE("GpuMemory::Update");
+	s_frame++;
+
+	// Sizes change with uploads and evictions, summing a few hundred objects is cheaper than tracking each change
+	size_t total = 0;
+	for (const GpuResident *resident : s_residents)
+		total += resident->GetGpuBytes();
+
+	if (total > s_budget)
+	{
+		std::vector<GpuResident *> candidates;
+		for (GpuResident *resident : s_residents)
+		{
+			if (s_frame - resident->m_lastUsedFrame >= s_evictionAge && resident->GetGpuBytes() > 0)
+				candidates.push_back(resident);
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const GpuResident *a, const GpuResident *b)
+			{
+				return a->m_lastUsedFrame < b->m_lastUsedFrame;
+			});
+
+		for (GpuResident *resident : candidates)
+		{
+			if (total <= s_budget)
+				break;
+
+			size_t bytes = resident->GetGpuBytes();
+			if (resident->Evict())
+			{
+				total -= bytes;
+				s_evictions++;
+			}
+		}
+	}
+
+	// Everything left is in use, only warn once per time the budget is exceeded
+	bool overBudget = total > s_budget;
+	if (overBudget && !s_overBudget)
+	{
+		std::cerr << "GPU memory over budget: " << total / 1024 << " KB of " << s_budget / 1024 << " KB" << std::endl;
+	}
+	s_overBudget = overBudget;
+	s_bytes = total;
+}
+
+GpuMemory::Stats GpuMemory::GetStats()
+{
+	Stats stats;
+	stats.bytes = s_bytes;
+	stats.objects = s_residents.size();
+	stats.evictions = s_evictions;
+	stats.restores = s_restores;
+	return stats;
+}
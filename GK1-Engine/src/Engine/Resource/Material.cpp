@@ -1,4 +1,7 @@
 #include "Engine/Resource/Material.h"
+#include "Engine/Profiler.h"
+#include "Engine/RenderStats.h"
+#include "Engine/ResourceManager.h"
 
 static constexpr char kDefaultVertexShader[] = R"(
 #version 330 core	
@@ -117,8 +120,10 @@ vec3 CalcLight(Light light, vec3 normal, vec3 fragPos, vec3 viewPos) {
 
 void main()
 {
-	vec3 Normal = texture(material.normalMap0, TexCoords).rgb;
-	Normal = Normal * 2.0 - 1.0;   
+	// Z is rebuilt from X and Y so two-channel (BC5) normal maps work too
+	vec3 Normal;
+	Normal.xy = texture(material.normalMap0, TexCoords).rg * 2.0 - 1.0;
+	Normal.z = sqrt(max(1.0 - dot(Normal.xy, Normal.xy), 0.0));
 	Normal = normalize(TBN * Normal); 
     
 	// Calculate lighting
@@ -143,11 +148,11 @@ void main()
 
 Material::Material() : m_properties{}
 {
-	auto shader = Shader::LoadFromString(kDefaultVertexShader, kDefaultFragmentShader);
-	SetShader(shader);
+	// Compiled once, every default material shares the program
+	SetShader(ResourceManager::Get().GetShaderCache().Load(kDefaultVertexShader, kDefaultFragmentShader));
 }
 
-Material::Material(std::shared_ptr<Shader> shader) : Material()
+Material::Material(std::shared_ptr<Shader> shader) : m_properties{}
 {
 	SetShader(shader);
 }
@@ -181,6 +186,7 @@ void Material::SetProperties(const Properties &props)
 
 void Material::Bind() const
 {
+	PROFILE_SCOPE("Material::Bind");
 	if (!m_shader) return;
 
 	m_shader->Use();
@@ -277,14 +283,15 @@ void Material::Bind() const
 
 void Material::Unbind() const
 {
-	// Unbind all textures
+	// Unbind all textures, in the slots Bind gave them
+	unsigned int textureSlot = 0;
 	for (const auto &[type, textures] : m_textures)
 	{
 		if (!textures.empty())
 		{
 			for (const auto &texture : textures)
 			{
-				texture->Unbind();
+				texture->Unbind(textureSlot++);
 			}
 		}
 	}
@@ -293,6 +300,7 @@ void Material::Unbind() const
 	if (m_shader)
 	{
 		glUseProgram(0);
+		RenderStats::UseProgram(0);
 	}
 }
 
@@ -0,0 +1,165 @@
+#include "Engine/Resource/MipGenerator.h"
+#include "Engine/JobSystem.h"
+#include "Engine/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace
+{
+	constexpr float kLobes = 2.0f;
+	constexpr float kPi = 3.14159265358979f;
+
+	float Lanczos(float x)
+	{
+		x = std::abs(x);
+		if (x < 1e-5f) return 1.0f;
+		if (x >= kLobes) return 0.0f;
+		float px = kPi * x;
+		return kLobes * std::sin(px) * std::sin(px / kLobes) / (px * px);
+	}
+
+	// Source pixels and normalized weights contributing to one target pixel along an axis
+	using Taps = std::vector<std::pair<int, float>>;
+
+	std::vector<Taps> ComputeTaps(int sourceSize, int targetSize)
+	{
+		// The kernel is stretched by the scale so it covers every source pixel of the target footprint
+		float scale = static_cast<float>(sourceSize) / targetSize;
+		float support = kLobes * scale;
+
+		std::vector<Taps> taps(targetSize);
+		for (int target = 0; target < targetSize; target++)
+		{
+			float center = (target + 0.5f) * scale;
+			int first = static_cast<int>(std::floor(center - support));
+			int last = static_cast<int>(std::ceil(center + support));
+
+			float sum = 0.0f;
+			for (int source = first; source <= last; source++)
+			{
+				float weight = Lanczos((source + 0.5f - center) / scale);
+				if (weight == 0.0f) continue;
+				// Edges are clamped, wrapping would bleed the opposite side of texture atlases into the mips
+				taps[target].emplace_back(std::clamp(source, 0, sourceSize - 1), weight);
+				sum += weight;
+			}
+			for (auto &tap : taps[target])
+				tap.second /= sum;
+		}
+		return taps;
+	}
+
+	template <typename T>
+	void Downsample(const T *source, int width, int height, T *target, int targetWidth, int targetHeight, int channels, bool normalMap)
+	{
+		constexpr float kMaxValue = static_cast<float>(std::numeric_limits<T>::max());
+		std::vector<Taps> columns = ComputeTaps(width, targetWidth);
+		std::vector<Taps> rows = ComputeTaps(height, targetHeight);
+
+		// Separable: horizontal pass into floats, then the vertical pass writes the level
+		std::vector<float> horizontal(static_cast<size_t>(height) * targetWidth * channels);
+		JobSystem::Get().ParallelFor(height, [&](size_t y)
+			{
+				const T *sourceRow = source + y * width * channels;
+				float *row = horizontal.data() + y * targetWidth * channels;
+				for (int x = 0; x < targetWidth; x++)
+				{
+					for (const auto &[column, weight] : columns[x])
+					{
+						for (int c = 0; c < channels; c++)
+							row[x * channels + c] += sourceRow[column * channels + c] * weight;
+					}
+				}
+			});
+
+		JobSystem::Get().ParallelFor(targetHeight, [&](size_t y)
+			{
+				T *targetRow = target + y * targetWidth * channels;
+				for (int x = 0; x < targetWidth; x++)
+				{
+					float value[4] = {};
+					for (const auto &[row, weight] : rows[y])
+					{
+						const float *pixel = horizontal.data() + (static_cast<size_t>(row) * targetWidth + x) * channels;
+						for (int c = 0; c < channels; c++)
+							value[c] += pixel[c] * weight;
+					}
+
+					// Averaged normals get shorter, which would darken lighting in the distance
+					if (normalMap && channels >= 3)
+					{
+						glm::vec3 normal = glm::vec3(value[0], value[1], value[2]) / kMaxValue * 2.0f - 1.0f;
+						float length = glm::length(normal);
+						normal = length > 1e-5f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+						normal = (normal * 0.5f + 0.5f) * kMaxValue;
+						value[0] = normal.x;
+						value[1] = normal.y;
+						value[2] = normal.z;
+					}
+
+					for (int c = 0; c < channels; c++)
+						targetRow[x * channels + c] = static_cast<T>(std::clamp(std::round(value[c]), 0.0f, kMaxValue));
+				}
+			});
+	}
+}
+
+void MipGenerator::Generate(Texture::Image &image, Texture::TextureType type)
+{
+	PROFILE_SCOPE("MipGenerator::Generate");
+
+	if (!image.pixels || image.compressedFormat != 0 || image.levelSizes.size() > 1 || image.layers != 1 || image.channels < 1 || image.channels > 4)
+	{
+		return;
+	}
+
+	bool wide = type == Texture::TextureType::Height;
+	size_t pixelSize = image.channels * (wide ? sizeof(uint16_t) : sizeof(uint8_t));
+
+	std::vector<size_t> levelSizes;
+	for (int width = image.width, height = image.height;; width = std::max(1, width / 2), height = std::max(1, height / 2))
+	{
+		levelSizes.push_back(static_cast<size_t>(width) * height * pixelSize);
+		if (width == 1 && height == 1) break;
+	}
+
+	size_t totalSize = 0;
+	for (size_t size : levelSizes)
+		totalSize += size;
+
+	uint8_t *pixels = static_cast<uint8_t *>(std::malloc(totalSize));
+	std::memcpy(pixels, image.pixels.get(), levelSizes[0]);
+
+	uint8_t *level = pixels;
+	int width = image.width;
+	int height = image.height;
+	for (size_t i = 1; i < levelSizes.size(); i++)
+	{
+		uint8_t *next = level + levelSizes[i - 1];
+		int nextWidth = std::max(1, width / 2);
+		int nextHeight = std::max(1, height / 2);
+		if (wide)
+		{
+			Downsample(reinterpret_cast<const uint16_t *>(level), width, height, reinterpret_cast<uint16_t *>(next),
+				nextWidth, nextHeight, image.channels, false);
+		}
+		else
+		{
+			Downsample(level, width, height, next, nextWidth, nextHeight, image.channels, type == Texture::TextureType::Normal);
+		}
+
+		level = next;
+		width = nextWidth;
+		height = nextHeight;
+	}
+
+	image.pixels.reset(pixels);
+	image.levelSizes = std::move(levelSizes);
+}
@@ -0,0 +1,195 @@
+#include "Engine/Resource/ProgramBinaryCache.h"
+#include "Engine/FileSystem.h"
+#include "Engine/Profiler.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+bool ProgramBinaryCache::s_enabled = true;
+std::string ProgramBinaryCache::s_directory = ProgramBinaryCache::kDefaultDirectory;
+ProgramBinaryCache::Stats ProgramBinaryCache::s_stats;
+
+namespace
+{
+	// PackFile already uses GK1P
+	constexpr char kMagic[4] = { 'G', 'K', '1', 'B' };
+
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceHash;
+		uint64_t driverHash;
+		uint32_t format;
+		uint32_t length;
+	};
+
+	// FNV-1a, continuing from hash so several pieces can be chained
+	uint64_t HashBytes(std::string_view bytes, uint64_t hash = 14695981039346656037ull)
+	{
+		for (char c : bytes)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::string_view GetString(GLenum name)
+	{
+		const GLubyte *value = glGetString(name);
+		return value ? reinterpret_cast<const char *>(value) : "";
+	}
+}
+
+bool ProgramBinaryCache::IsEnabled()
+{
+	// GL 4.1 or ARB_get_program_binary, and at least one format. Some drivers expose the entry points with none.
+	static const bool supported = []()
+		{
+			if (!glProgramBinary || !glGetProgramBinary)
+				return false;
+			GLint formats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+			return formats > 0;
+		}();
+	return s_enabled && supported;
+}
+
+std::string ProgramBinaryCache::GetCachePath(uint64_t sourceHash)
+{
+	uint64_t key = HashBytes(std::string_view(reinterpret_cast<const char *>(&sourceHash), sizeof(sourceHash)), GetDriverHash());
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.gk1prog", static_cast<unsigned long long>(key));
+	return (std::filesystem::path(s_directory) / name).string();
+}
+
+bool ProgramBinaryCache::Load(GLuint program, uint64_t sourceHash)
+{
+	if (!IsEnabled())
+		return false;
+
+	PROFILE_SCOPE("ProgramBinaryCache::Load");
+	std::string path = GetCachePath(sourceHash);
+	FileData file;
+	if (!FileSystem::Read(path, file))
+		return false;
+
+	std::string_view data = file.GetView();
+	FileHeader header;
+	if (data.size() < sizeof(header))
+		return false;
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0
+		|| header.version != kVersion
+		|| header.sourceHash != sourceHash
+		|| header.driverHash != GetDriverHash()
+		|| data.size() != sizeof(header) + header.length)
+	{
+		return false;
+	}
+
+	glProgramBinary(program, header.format, data.data() + sizeof(header), static_cast<GLsizei>(header.length));
+
+	// Drivers may still refuse binaries of their own version, for example after a settings change
+	GLint success = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		s_stats.rejected++;
+		// Windows cannot delete a file that is still mapped
+		file = FileData();
+		std::error_code error;
+		std::filesystem::remove(path, error);
+		if (error)
+			std::cerr << "Cannot remove rejected program binary: " << path << " (" << error.message() << ")" << std::endl;
+		return false;
+	}
+
+	s_stats.loaded++;
+	return true;
+}
+
+void ProgramBinaryCache::PrepareLink(GLuint program)
+{
+	if (IsEnabled())
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool ProgramBinaryCache::Store(GLuint program, uint64_t sourceHash)
+{
+	if (!IsEnabled())
+		return false;
+
+	PROFILE_SCOPE("ProgramBinaryCache::Store");
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return false;
+
+	std::vector<char> binary(static_cast<size_t>(length));
+	GLsizei written = 0;
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &written, &format, binary.data());
+	if (written <= 0)
+		return false;
+
+	FileHeader header{};
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.sourceHash = sourceHash;
+	header.driverHash = GetDriverHash();
+	header.format = format;
+	header.length = static_cast<uint32_t>(written);
+
+	std::error_code error;
+	std::filesystem::create_directories(s_directory, error);
+
+	// Write to a temporary file first so a crash never leaves a truncated binary behind
+	std::string cachePath = GetCachePath(sourceHash);
+	std::string tempPath = cachePath + ".tmp";
+	bool success;
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			std::cerr << "Cannot write program binary: " << tempPath << std::endl;
+			return false;
+		}
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		out.write(binary.data(), written);
+		success = static_cast<bool>(out);
+	}
+
+	if (success)
+	{
+		std::filesystem::rename(tempPath, cachePath, error);
+	}
+	if (!success || error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	s_stats.stored++;
+	return true;
+}
+
+uint64_t ProgramBinaryCache::GetDriverHash()
+{
+	static const uint64_t hash = []()
+		{
+			uint64_t value = HashBytes(GetString(GL_VENDOR));
+			value = HashBytes("|", value);
+			value = HashBytes(GetString(GL_RENDERER), value);
+			value = HashBytes("|", value);
+			return HashBytes(GetString(GL_VERSION), value);
+		}();
+	return hash;
+}
@@ -1,10 +1,12 @@
 #include "Engine/Resource/Shader.h"
+#include "Engine/FileSystem.h"
+#include "Engine/Resource/ProgramBinaryCache.h"
+#include "Engine/RenderStats.h"
+#include <algorithm>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <glm/gtc/type_ptr.hpp>
 
-Shader::Shader() : m_shaderProgram(0)
+Shader::Shader() : m_shaderProgram(0), m_programBytes(0)
 {
 }
 
@@ -15,36 +17,15 @@ Shader::~Shader()
 
 std::shared_ptr<Shader> Shader::LoadFromFile(const std::string &vertexPath, const std::string &fragmentPath)
 {
-	std::string vertexCode;
-	std::string fragmentCode;
-	std::ifstream vShaderFile;
-	std::ifstream fShaderFile;
-
-	vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-	try
-	{
-		vShaderFile.open(vertexPath);
-		fShaderFile.open(fragmentPath);
-		std::stringstream vShaderStream, fShaderStream;
-
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-
-		vShaderFile.close();
-		fShaderFile.close();
-
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
-	}
-	catch (std::ifstream::failure)
+	FileData vertexFile;
+	FileData fragmentFile;
+	if (!FileSystem::Read(vertexPath, vertexFile) || !FileSystem::Read(fragmentPath, fragmentFile))
 	{
 		std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
 		return nullptr;
 	}
 
-	return LoadFromString(vertexCode, fragmentCode);
+	return LoadFromString(std::string(vertexFile.GetView()), std::string(fragmentFile.GetView()));
 }
 
 std::shared_ptr<Shader> Shader::LoadFromString(const std::string &vertexSrc, const std::string &fragmentSrc)
@@ -63,21 +44,14 @@ std::shared_ptr<Shader> Shader::LoadFromString(const std::string &vertexSrc, con
 
 std::string Shader::ReadFile(const std::string &path)
 {
-	std::string content;
-	std::ifstream fileStream(path, std::ios::in);
-
-	if (!fileStream.is_open())
+	FileData file;
+	if (!FileSystem::Read(path, file))
 	{
 		std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
 		return "";
 	}
 
-	std::stringstream buffer;
-	buffer << fileStream.rdbuf();
-	content = buffer.str();
-
-	fileStream.close();
-	return content;
+	return std::string(file.GetView());
 }
 
 bool Shader::AddShaderStage(ShaderType type, const std::string &source)
@@ -129,6 +103,7 @@ bool Shader::AddShaderStage(ShaderType type, const std::string &source)
 
 bool Shader::Link()
 {
+	ProgramBinaryCache::PrepareLink(m_shaderProgram);
 	glLinkProgram(m_shaderProgram);
 
 	GLint success;
@@ -141,12 +116,38 @@ bool Shader::Link()
 		return false;
 	}
 
+	GLint binaryLength = 0;
+	glGetProgramiv(m_shaderProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	m_programBytes = static_cast<size_t>(std::max(binaryLength, 0));
 	return true;
 }
 
+bool Shader::LoadBinary(uint64_t sourceHash)
+{
+	if (m_shaderProgram == 0)
+	{
+		m_shaderProgram = glCreateProgram();
+	}
+
+	if (!ProgramBinaryCache::Load(m_shaderProgram, sourceHash))
+		return false;
+
+	GLint binaryLength = 0;
+	glGetProgramiv(m_shaderProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	m_programBytes = static_cast<size_t>(std::max(binaryLength, 0));
+	return true;
+}
+
+void Shader::StoreBinary(uint64_t sourceHash) const
+{
+	ProgramBinaryCache::Store(m_shaderProgram, sourceHash);
+}
+
 void Shader::Use() const
 {
+	MarkUsed();
 	glUseProgram(m_shaderProgram);
+	RenderStats::UseProgram(m_shaderProgram);
 }
 
 void Shader::BindUBO(const std::string &name, GLuint index)
@@ -171,39 +172,47 @@ GLint Shader::GetUniformLocation(const std::string &name)
 void Shader::SetBool(const std::string &name, bool value)
 {
 	glUniform1i(GetUniformLocation(name), static_cast<int>(value));
+	RenderStats::Current().uniformUploads++;
 }
 
 void Shader::SetInt(const std::string &name, int value)
 {
 	glUniform1i(GetUniformLocation(name), value);
+	RenderStats::Current().uniformUploads++;
 }
 
 void Shader::SetFloat(const std::string &name, float value)
 {
 	glUniform1f(GetUniformLocation(name), value);
+	RenderStats::Current().uniformUploads++;
 }
 
 void Shader::SetVec2(const std::string &name, const glm::vec2 &value)
 {
 	glUniform2fv(GetUniformLocation(name), 1, glm::value_ptr(value));
+	RenderStats::Current().uniformUploads++;
 }
 
 void Shader::SetVec3(const std::string &name, const glm::vec3 &value)
 {
 	glUniform3fv(GetUniformLocation(name), 1, glm::value_ptr(value));
+	RenderStats::Current().uniformUploads++;
 }
 
 void Shader::SetVec4(const std::string &name, const glm::vec4 &value)
 {
 	glUniform4fv(GetUniformLocation(name), 1, glm::value_ptr(value));
+	RenderStats::Current().uniformUploads++;
 }
 
 void Shader::SetMat3(const std::string &name, const glm::mat3 &value)
 {
 	glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+	RenderStats::Current().uniformUploads++;
 }
 
 void Shader::SetMat4(const std::string &name, const glm::mat4 &value)
 {
 	glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+	RenderStats::Current().uniformUploads++;
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "Engine/Resource/ShaderCache.h"
+#include "Engine/Profiler.h"
+
+#include <chrono>
+
+std::shared_ptr<Shader> ShaderCache::Load(std::span<const Stage> stages)
+{
+	uint64_t hash = Hash(stages);
+	auto it = m_programs.find(hash);
+	if (it != m_programs.end() && Matches(it->second, stages))
+	{
+		m_hits++;
+		it->second.hits++;
+		return it->second.shader;
+	}
+
+	PROFILE_SCOPE("ShaderCache::Compile");
+	m_misses++;
+	auto start = std::chrono::steady_clock::now();
+
+	// Programs linked on an earlier run come from the driver's binary, only new sources are compiled
+	auto shader = std::make_shared<Shader>();
+	if (!shader->LoadBinary(hash))
+	{
+		for (const Stage &stage : stages)
+		{
+			if (!shader->AddShaderStage(stage.type, std::string(stage.source)))
+				return nullptr;
+		}
+		if (!shader->Link())
+			return nullptr;
+		shader->StoreBinary(hash);
+	}
+
+	// A colliding hash keeps the program already cached, the new one is simply not shared
+	if (it != m_programs.end())
+		return shader;
+
+	Entry &entry = m_programs[hash];
+	for (const Stage &stage : stages)
+	{
+		entry.types.push_back(stage.type);
+		entry.sources.emplace_back(stage.source);
+	}
+	entry.shader = shader;
+	entry.compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return shader;
+}
+
+std::shared_ptr<Shader> ShaderCache::Load(std::string_view vertexSrc, std::string_view fragmentSrc)
+{
+	const Stage stages[] = { { Shader::ShaderType::Vertex, vertexSrc }, { Shader::ShaderType::Fragment, fragmentSrc } };
+	return Load(stages);
+}
+
+uint64_t ShaderCache::Hash(std::span<const Stage> stages)
+{
+	uint64_t hash = 14695981039346656037ull;
+	auto add = [&hash](uint8_t byte)
+		{
+			hash ^= byte;
+			hash *= 1099511628211ull;
+		};
+
+	for (const Stage &stage : stages)
+	{
+		// The type keeps the same sources in other stages apart
+		add(static_cast<uint8_t>(stage.type));
+		for (char c : stage.source)
+			add(static_cast<uint8_t>(c));
+		add(0);
+	}
+	return hash;
+}
+
+void ShaderCache::Clear()
+{
+	m_programs.clear();
+	m_hits = 0;
+	m_misses = 0;
+}
+
+ShaderCache::Stats ShaderCache::GetStats() const
+{
+	Stats stats;
+	stats.hits = m_hits;
+	stats.misses = m_misses;
+	for (const auto &[hash, entry] : m_programs)
+	{
+		stats.compileMs += entry.compileMs;
+		stats.savedMs += entry.hits * entry.compileMs;
+	}
+	return stats;
+}
+
+bool ShaderCache::Matches(const Entry &entry, std::span<const Stage> stages)
+{
+	if (entry.types.size() != stages.size())
+		return false;
+
+	for (size_t i = 0; i < stages.size(); i++)
+	{
+		if (entry.types[i] != stages[i].type || entry.sources[i] != stages[i].source)
+			return false;
+	}
+	return true;
+}
@@ -1,180 +1,485 @@
 #include "Engine/Resource/Texture.h"
+#include "Engine/FileSystem.h"
+#include "Engine/JobSystem.h"
+#include "Engine/Loader/LoaderFactory.h"
+#include "Engine/Loader/Texture/TextureLoader.h"
+#include "Engine/Profiler.h"
+#include "Engine/Resource/MipGenerator.h"
+#include "Engine/RenderStats.h"
+#include "Engine/TextureUploadRing.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
-#include <unordered_map>
+#include <numeric>
 
-Texture::Texture() : m_textureID(0), m_width(0), m_height(0), m_channels(0), m_data(nullptr),
-m_type(TextureType::Diffuse), m_format(GL_RGB), m_internalFormat(GL_RGB)
+std::atomic<size_t> Texture::s_cpuBytes = 0;
+size_t Texture::s_cpuBudget = Texture::kDefaultCpuBudget;
+std::vector<Texture *> Texture::s_restoreRequests;
+
+Texture::Texture() : m_textureID(0), m_width(0), m_height(0), m_channels(0), m_layers(1), m_data(nullptr),
+m_type(TextureType::Diffuse), m_format(GL_RGB), m_internalFormat(GL_RGB), m_byteSize(0), m_cpuByteSize(0), m_compressed(false),
+m_evictable(false), m_evicted(false), m_restoreRequested(false)
 {
 }
 
 Texture::~Texture()
 {
 	glDeleteTextures(1, &m_textureID);
-	if (m_data)
-	{
-		free(m_data);
-	}
+	ReleaseData();
+
+	if (m_restoreRequested)
+		std::erase(s_restoreRequests, this);
 }
 
-std::shared_ptr<Texture> Texture::LoadFromFile(const std::string &path, Texture::TextureType type, bool generateMipMaps)
+std::shared_ptr<Texture> Texture::LoadFromFile(const std::string &path, Texture::TextureType type, bool generateMipMaps, Residency residency)
 {
+	Image image;
+	if (!Decode(path, type, image))
+	{
+		return nullptr;
+	}
+
 	auto texture = std::make_shared<Texture>();
 	texture->m_type = type;
+	texture->Upload(std::move(image), generateMipMaps, residency);
+	return texture;
+}
+
+bool Texture::Decode(const std::string &path, Texture::TextureType type, Image &image, bool flipVertically)
+{
+	PROFILE_SCOPE("Texture::Decode");
+
+	// GL addresses cubemap faces with the first row at the top
+	if (type == TextureType::Cubemap || type == TextureType::CubemapArray)
+	{
+		flipVertically = false;
+	}
 
-	stbi_set_flip_vertically_on_load(true);
+	// Containers stb_image cannot read (DDS, KTX2) have their own loaders
+	if (auto loader = LoaderFactory<TextureLoader>::CreateLoader(std::filesystem::path(path).extension().string()))
+	{
+		if (!loader->Load(path, image, flipVertically))
+		{
+			std::cerr << "Failed to load texture: " << path << std::endl;
+			return false;
+		}
+		if (type == TextureType::Height && image.compressedFormat != 0)
+		{
+			// Terrain reads the heights back on the CPU
+			std::cerr << "Height maps cannot be block-compressed: " << path << std::endl;
+			image = Image();
+			return false;
+		}
+		return true;
+	}
+
+	FileData file;
+	if (!FileSystem::Read(path, file))
+	{
+		std::cerr << "Failed to open texture: " << path << std::endl;
+		return false;
+	}
+
+	// The flag is per thread, decodes running in parallel must not share it
+	stbi_set_flip_vertically_on_load_thread(flipVertically);
+	auto encoded = reinterpret_cast<const stbi_uc *>(file.GetData());
+	int encodedSize = static_cast<int>(file.GetSize());
+	uint8_t *pixels;
 	if (type == TextureType::Height)
 	{
-		texture->m_data = (uint8_t*)stbi_load_16(path.c_str(), &texture->m_width, &texture->m_height, &texture->m_channels, 0);
+		pixels = (uint8_t *)stbi_load_16_from_memory(encoded, encodedSize, &image.width, &image.height, &image.channels, 0);
 	}
 	else
 	{
-		texture->m_data = stbi_load(path.c_str(), &texture->m_width, &texture->m_height, &texture->m_channels, 0);
+		pixels = stbi_load_from_memory(encoded, encodedSize, &image.width, &image.height, &image.channels, 0);
 	}
 
-	if (!texture->m_data)
+	if (!pixels)
 	{
 		std::cerr << "Failed to load texture: " << path << std::endl;
-		return nullptr;
+		return false;
 	}
 
-	// unordered map for channel mapping
-	std::unordered_map<int, int> channelMap = {
-		{1, GL_RED},
-		{3, GL_RGB},
-		{4, GL_RGBA}
-	};
-	texture->m_format = channelMap[texture->m_channels];
-	texture->m_internalFormat = texture->m_format;
-	if (type == TextureType::Height)
+	image.pixels.reset(pixels);
+	return true;
+}
+
+void Texture::Upload(Image &&image, bool generateMipMaps, Residency residency)
+{
+	PROFILE_SCOPE("Texture::Upload");
+
+	ReleaseData();
+	m_evicted = false;
+	m_restoreRequested = false;
+
+	if (m_type == TextureType::CubemapArray)
+	{
+		UploadCubemapArray(std::move(image));
+		return;
+	}
+
+	// Async loads already did this on a decode job
+	if (generateMipMaps)
+	{
+		MipGenerator::Generate(image, m_type);
+	}
+
+	m_width = image.width;
+	m_height = image.height;
+	m_channels = image.channels;
+	m_byteSize = GetByteSize(image, m_type);
+	m_compressed = image.compressedFormat != 0;
+
+	if (m_textureID == 0)
+	{
+		glGenTextures(1, &m_textureID);
+	}
+	BindForUpload(GL_TEXTURE_2D);
+
+	if (m_compressed)
 	{
-		texture->m_internalFormat = GL_R16;
+		// No CPU copy is kept even when asked for, GetPixel cannot read blocks
+		m_format = image.compressedFormat;
+		m_internalFormat = image.compressedFormat;
+		size_t levelCount = std::max<size_t>(image.levelSizes.size(), 1);
+		UploadCompressed(GL_TEXTURE_2D, image, levelCount);
+
+		// Block formats are not renderable, so only the levels stored in the file can be sampled
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levelCount - 1));
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		image = Image();
+		return;
 	}
 
-	glGenTextures(1, &texture->m_textureID);
-	glBindTexture(GL_TEXTURE_2D, texture->m_textureID);
+	m_format = GetPixelFormat(m_channels);
+	m_internalFormat = m_format;
+	if (m_type == TextureType::Height)
+	{
+		m_internalFormat = GL_R16;
+	}
 
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
 	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, texture->m_internalFormat, texture->m_width,
-				 texture->m_height, 0, texture->m_format, (type != TextureType::Height) ? GL_UNSIGNED_BYTE : GL_SHORT, texture->m_data);
-
-	if (generateMipMaps)
+	// Levels come from MipGenerator or a cooked file, the GPU does not build any
+	size_t levelCount = std::max<size_t>(image.levelSizes.size(), 1);
+	const uint8_t *level = image.pixels.get();
+	for (size_t i = 0; i < levelCount; i++)
 	{
-		glGenerateMipmap(GL_TEXTURE_2D);
+		size_t size = image.levelSizes.empty() ? m_byteSize : image.levelSizes[i];
+		TextureUploadRing::TexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), m_internalFormat, std::max(1, m_width >> i), std::max(1, m_height >> i),
+			m_format, (m_type != TextureType::Height) ? GL_UNSIGNED_BYTE : GL_SHORT, level, size);
+		level += size;
 	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levelCount - 1));
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (type != TextureType::Height) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (type != TextureType::Height) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, generateMipMaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (m_type != TextureType::Height) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (m_type != TextureType::Height) ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-	return texture;
+	// The upload ring copied the pixels, the GPU owns them now
+	if (residency == Residency::KeepCpuCopy)
+	{
+		KeepData(std::move(image));
+	}
+	else
+	{
+		image = Image();
+	}
 }
 
-std::shared_ptr<Texture> Texture::LoadFromData(const uint8_t *data, int width, int height,
-											   int channels, Texture::TextureType type, bool generateMipMaps)
+void Texture::KeepData(Image &&image)
 {
-	auto texture = std::make_shared<Texture>();
+	m_data = image.pixels.release();
+	m_cpuByteSize = m_byteSize;
 
-	texture->m_width = width;
-	texture->m_height = height;
-	texture->m_channels = channels;
-	std::unordered_map<int, int> channelMap = {
-		{1, GL_RED},
-		{3, GL_RGB},
-		{4, GL_RGBA}
-	};
-	texture->m_format = channelMap[channels];
-	texture->m_internalFormat = texture->m_format;
-	texture->m_type = type;
-	texture->m_data = (uint8_t*)malloc(width * height * channels);
-
-	glGenTextures(1, &texture->m_textureID);
-	glBindTexture(GL_TEXTURE_2D, texture->m_textureID);
-
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
-	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
-
-	glTexImage2D(GL_TEXTURE_2D, 0, texture->m_internalFormat, width, height, 0,
-				 texture->m_format, GL_UNSIGNED_BYTE, data);
+	size_t total = s_cpuBytes += m_cpuByteSize;
+	if (total > s_cpuBudget && total - m_cpuByteSize <= s_cpuBudget)
+	{
+		std::cerr << "CPU texture memory over budget: " << total / 1024 << " KB of " << s_cpuBudget / 1024 << " KB" << std::endl;
+	}
+}
 
-	if (generateMipMaps)
+void Texture::ReleaseData()
+{
+	if (m_data)
 	{
-		glGenerateMipmap(GL_TEXTURE_2D);
+		free(m_data);
+		m_data = nullptr;
+		s_cpuBytes -= m_cpuByteSize;
+		m_cpuByteSize = 0;
 	}
+}
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, generateMipMaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+std::shared_ptr<Texture> Texture::LoadFromData(const uint8_t *data, int width, int height,
+											   int channels, Texture::TextureType type, bool generateMipMaps)
+{
+	// Copied because Upload takes ownership, the copy is freed again right after the upload
+	Image image;
+	size_t size = static_cast<size_t>(width) * height * channels * (type == TextureType::Height ? 2 : 1);
+	image.pixels.reset(static_cast<uint8_t *>(std::malloc(size)));
+	std::copy_n(data, size, image.pixels.get());
+	image.width = width;
+	image.height = height;
+	image.channels = channels;
 
+	auto texture = std::make_shared<Texture>();
+	texture->m_type = type;
+	texture->Upload(std::move(image), generateMipMaps);
 	return texture;
 }
 
 std::shared_ptr<Texture> Texture::CreateCubemap(const std::vector<std::string> &faces)
 {
+	// Faces are independent, decode them on all cores
+	std::vector<Image> images(faces.size());
+	JobSystem::Get().ParallelFor(faces.size(), [&faces, &images](size_t i)
+		{
+			Decode(faces[i], TextureType::Cubemap, images[i], false);
+		});
+
 	auto texture = std::make_shared<Texture>();
 	texture->m_type = TextureType::Cubemap;
+	texture->UploadCubemap(std::move(images));
+	return texture;
+}
+
+void Texture::UploadCubemap(std::vector<Image> &&faces)
+{
+	PROFILE_SCOPE("Texture::UploadCubemap");
+
+	// Immutable storage has one size and format, taken from the first face that decoded. Failed faces were reported
+	// by Decode and stay black, if all of them failed the storage is a single black texel.
+	auto first = std::find_if(faces.begin(), faces.end(), [](const Image &face) { return face.pixels != nullptr; });
+	m_width = first != faces.end() ? first->width : 1;
+	m_height = first != faces.end() ? first->height : 1;
+	m_channels = first != faces.end() ? first->channels : 3;
+	m_compressed = first != faces.end() && first->compressedFormat != 0;
+	if (m_compressed)
+	{
+		m_internalFormat = first->compressedFormat;
+	}
+	else
+	{
+		bool alpha = std::any_of(faces.begin(), faces.end(), [](const Image &face) { return face.channels == 4; });
+		m_internalFormat = alpha ? GL_RGBA8 : GL_RGB8;
+	}
+	m_format = m_internalFormat;
 
-	glGenTextures(1, &texture->m_textureID);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, texture->m_textureID);
+	// Storage cannot be respecified, a reload gets a new texture
+	glDeleteTextures(1, &m_textureID);
+	glGenTextures(1, &m_textureID);
+	BindForUpload(GL_TEXTURE_CUBE_MAP);
+	// The skybox is only magnified, mips would never be sampled
+	glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, m_internalFormat, m_width, m_height);
+	m_byteSize = 0;
+	// Sizes passed to the upload ring assume tightly packed rows
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	for (unsigned int i = 0; i < faces.size(); i++)
 	{
-		int width, height, channels;
-		unsigned char *data = stbi_load(faces[i].c_str(), &width, &height, &channels, 0);
-
-		if (!data)
+		const Image &face = faces[i];
+		if (!face.pixels)
 		{
-			std::cerr << "Failed to load cubemap texture: " << faces[i] << std::endl;
+			continue;
+		}
+		if (face.width != m_width || face.height != m_height || (face.compressedFormat != 0) != m_compressed
+			|| (m_compressed && face.compressedFormat != m_internalFormat))
+		{
+			std::cerr << "Cubemap face " << i << " does not match the size and format of the first face" << std::endl;
 			continue;
 		}
 
-		GLenum format = channels == 4 ? GL_RGBA : GL_RGB;
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, width, height,
-					 0, format, GL_UNSIGNED_BYTE, data);
-		stbi_image_free(data);
+		// Only the base level of faces with stored mips is used
+		GLenum target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
+		size_t size = face.levelSizes.empty() ? GetByteSize(face, TextureType::Cubemap) : face.levelSizes[0];
+		if (m_compressed)
+		{
+			TextureUploadRing::CompressedTexSubImage2D(target, 0, m_width, m_height, m_internalFormat, face.pixels.get(), size);
+		}
+		else
+		{
+			TextureUploadRing::TexSubImage2D(target, 0, m_width, m_height, GetPixelFormat(face.channels), GL_UNSIGNED_BYTE,
+				face.pixels.get(), size);
+		}
+		m_byteSize += size;
 	}
+	faces.clear();
 
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+}
 
-	return texture;
+void Texture::UploadCubemapArray(Image &&image)
+{
+	PROFILE_SCOPE("Texture::UploadCubemapArray");
+
+	if (image.pixels && (image.layers % 6 != 0 || image.width != image.height))
+	{
+		std::cerr << "Cubemap arrays need square faces and six faces per cube" << std::endl;
+		image = Image();
+	}
+	if (!image.pixels)
+	{
+		// Leaves one black cube so the texture still counts as loaded
+		image.width = image.height = 1;
+		image.channels = 3;
+		image.layers = 6;
+	}
+
+	m_width = image.width;
+	m_height = image.height;
+	m_channels = image.channels;
+	m_layers = image.layers / 6;
+	m_compressed = image.compressedFormat != 0;
+	m_format = m_compressed ? image.compressedFormat : GetPixelFormat(image.channels);
+	m_internalFormat = m_compressed ? image.compressedFormat : image.channels == 4 ? GL_RGBA8 : GL_RGB8;
+	m_byteSize = 0;
+
+	glDeleteTextures(1, &m_textureID);
+	glGenTextures(1, &m_textureID);
+	BindForUpload(GL_TEXTURE_CUBE_MAP_ARRAY);
+
+	size_t levelCount = std::max<size_t>(image.levelSizes.size(), 1);
+	glTexStorage3D(GL_TEXTURE_CUBE_MAP_ARRAY, static_cast<GLsizei>(levelCount), m_internalFormat, m_width, m_height, image.layers);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	// Every level holds all layer-faces back to back, so one upload per level fills it
+	const uint8_t *level = image.pixels.get();
+	for (size_t i = 0; level && i < levelCount; i++)
+	{
+		GLsizei width = std::max(1, m_width >> i);
+		GLsizei height = std::max(1, m_height >> i);
+		size_t size = image.levelSizes.empty() ? GetByteSize(image, m_type) : image.levelSizes[i];
+		if (m_compressed)
+		{
+			TextureUploadRing::CompressedTexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, static_cast<GLint>(i), width, height, image.layers,
+				m_format, level, size);
+		}
+		else
+		{
+			TextureUploadRing::TexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, static_cast<GLint>(i), width, height, image.layers,
+				m_format, GL_UNSIGNED_BYTE, level, size);
+		}
+		level += size;
+		m_byteSize += size;
+	}
+	image = Image();
+
+	glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 }
 
-void Texture::Bind(unsigned int slot) const
+size_t Texture::UploadCompressed(GLenum target, const Image &image, size_t levelCount)
 {
-	glActiveTexture(GL_TEXTURE0 + slot);
-	if (m_type == TextureType::Cubemap)
+	const uint8_t *level = image.pixels.get();
+	size_t uploaded = 0;
+	for (size_t i = 0; i < levelCount && i < image.levelSizes.size(); i++)
 	{
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_textureID);
+		GLsizei width = std::max(1, image.width >> i);
+		GLsizei height = std::max(1, image.height >> i);
+		TextureUploadRing::CompressedTexImage2D(target, static_cast<GLint>(i), image.compressedFormat, width, height, level, image.levelSizes[i]);
+		level += image.levelSizes[i];
+		uploaded += image.levelSizes[i];
 	}
-	else
+	return uploaded;
+}
+
+size_t Texture::GetByteSize(const Image &image, TextureType type)
+{
+	if (!image.levelSizes.empty())
 	{
-		glBindTexture(GL_TEXTURE_2D, m_textureID);
+		return std::accumulate(image.levelSizes.begin(), image.levelSizes.end(), size_t(0));
 	}
+	return static_cast<size_t>(image.width) * image.height * image.channels * image.layers * (type == TextureType::Height ? 2 : 1);
 }
 
-void Texture::Unbind() const
+GLenum Texture::GetPixelFormat(int channels)
 {
-	if (m_type == TextureType::Cubemap)
+	static constexpr GLenum kFormats[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+	return channels >= 1 && channels <= 4 ? kFormats[channels - 1] : GL_RGB;
+}
+
+GLenum Texture::GetTarget() const
+{
+	switch (m_type)
 	{
-		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	case TextureType::Cubemap:
+		return GL_TEXTURE_CUBE_MAP;
+	case TextureType::CubemapArray:
+		return GL_TEXTURE_CUBE_MAP_ARRAY;
+	default:
+		return GL_TEXTURE_2D;
 	}
-	else
+}
+
+bool Texture::Evict()
+{
+	if (!m_evictable || m_textureID == 0 || m_type == TextureType::Height || GetTarget() != GL_TEXTURE_2D)
+		return false;
+
+	glDeleteTextures(1, &m_textureID);
+	m_textureID = 0;
+	m_evicted = true;
+	return true;
+}
+
+std::vector<Texture *> Texture::TakeRestoreRequests()
+{
+	// Textures stay flagged until uploaded, so binds during the decode do not request them again
+	std::vector<Texture *> requests;
+	requests.swap(s_restoreRequests);
+	return requests;
+}
+
+void Texture::Bind(unsigned int slot) const
+{
+	MarkUsed();
+	if (m_evicted && !m_restoreRequested)
+	{
+		m_restoreRequested = true;
+		s_restoreRequests.push_back(const_cast<Texture *>(this));
+	}
+
+	// Still loading asynchronously, sample the neutral default instead of an incomplete texture. Height maps and
+	// cubemaps stay unbound, zero height is flat and the skybox is not drawn until it arrives.
+	if (m_textureID == 0 && m_type != TextureType::Height && GetTarget() == GL_TEXTURE_2D)
 	{
-		glBindTexture(GL_TEXTURE_2D, 0);
+		GetDefaultTexture(m_type == TextureType::Normal)->Bind(slot);
+		return;
 	}
+
+	RenderStats::BindTexture(slot, m_textureID);
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GetTarget(), m_textureID);
+}
+
+void Texture::BindForUpload(GLenum target) const
+{
+	RenderStats::BindTexture(0, m_textureID);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(target, m_textureID);
+}
+
+void Texture::Unbind(unsigned int slot) const
+{
+	RenderStats::BindTexture(slot, 0);
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GetTarget(), 0);
 }
 
 std::shared_ptr<Texture> Texture::GetDefaultTexture(bool normalmap)
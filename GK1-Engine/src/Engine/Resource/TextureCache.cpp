@@ -0,0 +1,437 @@
+#include "Engine/Resource/TextureCache.h"
+#include "Engine/FileSystem.h"
+#include "Engine/JobSystem.h"
+#include "Engine/Profiler.h"
+#include "Engine/Resource/GpuMemory.h"
+#include "Engine/Resource/MipGenerator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+
+std::shared_ptr<Texture> TextureCache::Load(const std::string &path, Texture::TextureType type, bool generateMipMaps,
+	Texture::Residency residency)
+{
+	std::string key = MakeKey(path, type, generateMipMaps, residency);
+	if (auto texture = FindEntry(key))
+	{
+		// Requested earlier without waiting, the caller needs it now
+		if (m_textures[key].reserved)
+		{
+			// Filled by a LoadGraph node this cache cannot drive
+			Texture::Image image;
+			bool decoded = Decode(path, type, generateMipMaps, image);
+			Fill(texture, path, generateMipMaps, residency, std::move(image), decoded);
+		}
+		else
+		{
+			WaitFor(*texture);
+		}
+		return texture;
+	}
+
+	m_misses++;
+	std::string resolvedPath = ResolvePath(path, type);
+	auto texture = Texture::LoadFromFile(resolvedPath, type, generateMipMaps, residency);
+	if (!texture && resolvedPath != path)
+	{
+		// Same fallback as Decode
+		texture = Texture::LoadFromFile(path, type, generateMipMaps, residency);
+	}
+	if (texture)
+	{
+		// Failures are not cached so a fixed file can be picked up by the next load
+		Entry &entry = m_textures[key];
+		entry.texture = texture;
+		entry.path = path;
+		entry.generateMipMaps = generateMipMaps;
+		entry.residency = residency;
+		texture->SetEvictable(residency == Texture::Residency::GpuOnly);
+	}
+	return texture;
+}
+
+std::shared_ptr<Texture> TextureCache::LoadAsync(const std::string &path, Texture::TextureType type, bool generateMipMaps,
+	Texture::Residency residency)
+{
+	std::string key = MakeKey(path, type, generateMipMaps, residency);
+	if (auto texture = FindEntry(key))
+		return texture;
+
+	auto texture = AddEntry(key, path, type, generateMipMaps, residency);
+	m_pending++;
+	SubmitDecode(key, texture, path, generateMipMaps, residency);
+	return texture;
+}
+
+std::shared_ptr<Texture> TextureCache::LoadCubemapAsync(const std::vector<std::string> &faces)
+{
+	std::string key = "cubemap";
+	for (const auto &face : faces)
+		key += "|" + CanonicalPath(face);
+
+	if (auto texture = FindEntry(key))
+		return texture;
+
+	m_misses++;
+	auto texture = std::make_shared<Texture>();
+	texture->SetType(Texture::TextureType::Cubemap);
+	m_textures[key].texture = texture;
+	m_pending++;
+
+	JobSystem::Get().Submit([queue = m_queue, key, texture, faces]() mutable
+		{
+			Decoded decoded;
+			decoded.key = std::move(key);
+			decoded.texture = std::move(texture);
+			decoded.images.resize(faces.size());
+			// Missing faces stay black like in Texture::CreateCubemap
+			decoded.success = true;
+			JobSystem::Get().ParallelFor(faces.size(), [&faces, &decoded](size_t i)
+				{
+					Texture::Decode(ResolvePath(faces[i], Texture::TextureType::Cubemap), Texture::TextureType::Cubemap, decoded.images[i], false);
+				});
+			for (const auto &image : decoded.images)
+				decoded.bytes += Texture::GetByteSize(image, Texture::TextureType::Cubemap);
+
+			std::lock_guard<std::mutex> lock(queue->mutex);
+			queue->decoded.push_back(std::move(decoded));
+			queue->ready.notify_one();
+		});
+	return texture;
+}
+
+std::shared_ptr<Texture> TextureCache::Reserve(const std::string &path, Texture::TextureType type, bool generateMipMaps,
+	Texture::Residency residency, bool &reserved)
+{
+	std::string key = MakeKey(path, type, generateMipMaps, residency);
+	reserved = false;
+	if (auto texture = FindEntry(key))
+		return texture;
+
+	reserved = true;
+	auto texture = AddEntry(key, path, type, generateMipMaps, residency);
+	m_textures[key].reserved = true;
+	return texture;
+}
+
+bool TextureCache::Decode(const std::string &path, Texture::TextureType type, bool generateMipMaps, Texture::Image &image)
+{
+	std::string resolvedPath = ResolvePath(path, type);
+	if (!Texture::Decode(resolvedPath, type, image))
+	{
+		// A cooked file this build cannot use, the source still works
+		if (resolvedPath == path)
+			return false;
+		image = Texture::Image();
+		if (!Texture::Decode(path, type, image))
+			return false;
+	}
+
+	if (generateMipMaps)
+	{
+		// Keeps the filtering off the GL thread, Upload finds the levels already there
+		MipGenerator::Generate(image, type);
+	}
+	return true;
+}
+
+void TextureCache::Fill(const std::shared_ptr<Texture> &texture, const std::string &path, bool generateMipMaps,
+	Texture::Residency residency, Texture::Image &&image, bool decoded)
+{
+	std::string key = MakeKey(path, texture->GetType(), generateMipMaps, residency);
+	auto it = m_textures.find(key);
+	if (it != m_textures.end() && it->second.texture == texture)
+		it->second.reserved = false;
+
+	// Load got to it first
+	if (texture->IsLoaded())
+		return;
+
+	Decoded filled;
+	filled.key = std::move(key);
+	filled.texture = texture;
+	filled.generateMipMaps = generateMipMaps;
+	filled.residency = residency;
+	filled.images.push_back(std::move(image));
+	filled.success = decoded;
+
+	// Upload settles a pending load, reserved textures were not counted as one
+	m_pending++;
+	Upload(filled);
+}
+
+void TextureCache::ProcessUploads()
+{
+	PROFILE_SCOPE("TextureCache::ProcessUploads");
+	Restore(Texture::TakeRestoreRequests());
+	CollectDecoded(false);
+
+	size_t uploaded = 0;
+	while (!m_ready.empty() && (uploaded == 0 || uploaded + m_ready.front().bytes <= m_uploadBudget))
+	{
+		uploaded += m_ready.front().bytes;
+		Upload(m_ready.front());
+		m_ready.pop_front();
+	}
+}
+
+void TextureCache::WaitForUploads()
+{
+	PROFILE_SCOPE("TextureCache::WaitForUploads");
+
+	// Loading screens want everything now, the budget does not apply
+	while (m_pending > 0)
+	{
+		if (m_ready.empty())
+			CollectDecoded(true);
+
+		while (!m_ready.empty())
+		{
+			Upload(m_ready.front());
+			m_ready.pop_front();
+		}
+	}
+}
+
+void TextureCache::WaitFor(const Texture &texture)
+{
+	PROFILE_SCOPE("TextureCache::WaitFor");
+
+	// Failed decodes are uploaded as a default pixel, so every pending texture ends up loaded
+	while (!texture.IsLoaded() && m_pending > 0)
+	{
+		auto it = std::find_if(m_ready.begin(), m_ready.end(), [&texture](const Decoded &decoded)
+			{
+				return decoded.texture.get() == &texture;
+			});
+
+		if (it != m_ready.end())
+		{
+			Upload(*it);
+			m_ready.erase(it);
+		}
+		else if (m_ready.size() < m_pending)
+		{
+			CollectDecoded(true);
+		}
+		else
+		{
+			// Every decode in flight is already collected, the texture is filled by someone else
+			return;
+		}
+	}
+}
+
+void TextureCache::CollectDecoded(bool wait)
+{
+	std::unique_lock<std::mutex> lock(m_queue->mutex);
+	if (wait)
+	{
+		m_queue->ready.wait(lock, [this]() { return !m_queue->decoded.empty(); });
+	}
+
+	for (auto &decoded : m_queue->decoded)
+	{
+		m_ready.push_back(std::move(decoded));
+	}
+	m_queue->decoded.clear();
+}
+
+void TextureCache::Upload(Decoded &decoded)
+{
+	m_pending--;
+
+	if (decoded.texture->GetType() == Texture::TextureType::Cubemap)
+	{
+		decoded.texture->UploadCubemap(std::move(decoded.images));
+		return;
+	}
+
+	if (!decoded.success)
+	{
+		// Materials already hold the texture, give it the same neutral pixel as Texture::GetDefaultTexture
+		// and let the next load retry the file
+		auto it = m_textures.find(decoded.key);
+		if (it != m_textures.end() && it->second.texture == decoded.texture)
+			m_textures.erase(it);
+		// Without an entry there is nothing to restore it from
+		decoded.texture->SetEvictable(false);
+
+		if (decoded.texture->GetType() == Texture::TextureType::CubemapArray)
+		{
+			// Uploaded as one black cube
+			decoded.texture->Upload(Texture::Image(), false);
+			return;
+		}
+
+		const uint8_t white[] = { 255, 255, 255 };
+		const uint8_t flatNormal[] = { 128, 128, 255 };
+		bool isNormal = decoded.texture->GetType() == Texture::TextureType::Normal;
+
+		Texture::Image fallback;
+		fallback.pixels.reset(static_cast<uint8_t *>(std::malloc(sizeof(white))));
+		std::copy_n(isNormal ? flatNormal : white, sizeof(white), fallback.pixels.get());
+		fallback.width = fallback.height = 1;
+		fallback.channels = decoded.texture->GetType() == Texture::TextureType::Height ? 1 : 3;
+		decoded.texture->Upload(std::move(fallback), false, decoded.residency);
+		return;
+	}
+
+	decoded.texture->Upload(std::move(decoded.images[0]), decoded.generateMipMaps, decoded.residency);
+	decoded.texture->SetEvictable(decoded.residency == Texture::Residency::GpuOnly);
+}
+
+void TextureCache::Restore(const std::vector<Texture *> &textures)
+{
+	for (Texture *texture : textures)
+	{
+		auto it = std::find_if(m_textures.begin(), m_textures.end(), [texture](const auto &entry)
+			{
+				return entry.second.texture.get() == texture;
+			});
+		if (it == m_textures.end())
+			continue;
+
+		// Decoded from the cooked file again if there is one, the texture samples the default until then
+		m_pending++;
+		SubmitDecode(it->first, it->second.texture, it->second.path, it->second.generateMipMaps, it->second.residency);
+		GpuMemory::AddRestore();
+	}
+}
+
+void TextureCache::Clear()
+{
+	WaitForUploads();
+
+	std::vector<Texture *> evicted;
+	for (const auto &[key, entry] : m_textures)
+	{
+		entry.texture->SetEvictable(false);
+		if (entry.texture->IsEvicted())
+			evicted.push_back(entry.texture.get());
+	}
+	Restore(evicted);
+	WaitForUploads();
+
+	m_textures.clear();
+	m_hits = 0;
+	m_misses = 0;
+}
+
+TextureCache::Stats TextureCache::GetStats() const
+{
+	Stats stats;
+	stats.hits = m_hits;
+	stats.misses = m_misses;
+	for (const auto &[key, entry] : m_textures)
+	{
+		// Sizes are only known once decoded, so savings are tallied here rather than at the time of the hit
+		stats.bytesSaved += entry.hits * entry.texture->GetByteSize();
+	}
+	return stats;
+}
+
+std::shared_ptr<Texture> TextureCache::AddEntry(const std::string &key, const std::string &path, Texture::TextureType type,
+	bool generateMipMaps, Texture::Residency residency)
+{
+	m_misses++;
+	auto texture = std::make_shared<Texture>();
+	texture->SetType(type);
+
+	Entry &entry = m_textures[key];
+	entry.texture = texture;
+	entry.path = path;
+	entry.generateMipMaps = generateMipMaps;
+	entry.residency = residency;
+	return texture;
+}
+
+void TextureCache::SubmitDecode(const std::string &key, const std::shared_ptr<Texture> &texture, const std::string &path,
+	bool generateMipMaps, Texture::Residency residency)
+{
+	JobSystem::Get().Submit([queue = m_queue, key, texture, path, type = texture->GetType(), generateMipMaps, residency]() mutable
+		{
+			// Moved so the last reference is never released on a worker, Texture destructors need the GL thread
+			Decoded decoded;
+			decoded.key = std::move(key);
+			decoded.texture = std::move(texture);
+			decoded.generateMipMaps = generateMipMaps;
+			decoded.residency = residency;
+			decoded.images.resize(1);
+			decoded.success = Decode(path, type, generateMipMaps, decoded.images[0]);
+			decoded.bytes = Texture::GetByteSize(decoded.images[0], type);
+
+			std::lock_guard<std::mutex> lock(queue->mutex);
+			queue->decoded.push_back(std::move(decoded));
+			queue->ready.notify_one();
+		});
+}
+
+std::shared_ptr<Texture> TextureCache::FindEntry(const std::string &key)
+{
+	auto it = m_textures.find(key);
+	if (it == m_textures.end())
+		return nullptr;
+
+	m_hits++;
+	it->second.hits++;
+	return it->second.texture;
+}
+
+std::string TextureCache::CanonicalPath(const std::string &path)
+{
+	// Purely lexical, packed files may not exist on disk
+	return FileSystem::Normalize(path);
+}
+
+std::string TextureCache::GetCookedPath(const std::string &sourcePath)
+{
+	// The source extension stays in the name, foo.png and foo.jpg must not share one cooked file
+	return sourcePath + ".ktx2";
+}
+
+bool TextureCache::IsCookedUpToDate(const std::string &sourcePath)
+{
+	return IsCookedUpToDate(GetCookedPath(sourcePath), { sourcePath });
+}
+
+bool TextureCache::IsCookedUpToDate(const std::string &cookedPath, const std::vector<std::string> &sourcePaths)
+{
+	FileSystem::Info cooked;
+	if (!FileSystem::GetInfo(cookedPath, cooked))
+		return false;
+
+	// Shipping only the cooked file is fine, an edited source wins until it is cooked again
+	for (const auto &sourcePath : sourcePaths)
+	{
+		FileSystem::Info source;
+		if (FileSystem::GetInfo(sourcePath, source) && source.time > cooked.time)
+			return false;
+	}
+	return true;
+}
+
+std::string TextureCache::ResolvePath(const std::string &path, Texture::TextureType type)
+{
+	std::string cookedPath = GetCookedPath(path);
+	if (type == Texture::TextureType::Height || !IsCookedUpToDate(path))
+		return path;
+	return cookedPath;
+}
+
+std::string TextureCache::MakeKey(const std::string &path, Texture::TextureType type, bool generateMipMaps,
+	Texture::Residency residency)
+{
+	// Height maps are decoded to 16 bits and mip-less textures get different sampling, keep them apart. Normal maps
+	// get renormalized mips and a flat fallback while loading or evicted, so they never share with color maps.
+	// A texture that dropped its pixels cannot serve a caller that reads them.
+	std::string key = CanonicalPath(path);
+	if (type == Texture::TextureType::Height)
+		key += "|16";
+	else
+		key += type == Texture::TextureType::Normal ? "|normal" : "|8";
+	key += generateMipMaps ? "|mips" : "";
+	key += residency == Texture::Residency::KeepCpuCopy ? "|cpu" : "";
+	return key;
+}
@@ -0,0 +1,235 @@
+#include "Engine/ResourceManager.h"
+#include "Engine/FileSystem.h"
+#include "Engine/Loader/LoaderFactory.h"
+#include "Engine/Log.h"
+#include "Engine/Profiler.h"
+#include "Engine/Resource/GpuMemory.h"
+#include "Engine/Resource/ProgramBinaryCache.h"
+
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+void ResourceManager::FreeSlot(SlotArray &slots, uint32_t index)
+{
+	Slot &slot = slots.slots[index];
+	slots.byName.erase(slot.name);
+	slot.resource.reset();
+	slot.name.clear();
+	// 0 is reserved for invalid handles
+	if (++slot.generation == 0)
+		slot.generation = 1;
+	slots.freeSlots.push_back(index);
+}
+
+void ResourceManager::ClearSlots(SlotArray &slots)
+{
+	// Copied first, FreeSlot erases from the name map
+	std::vector<uint32_t> used;
+	for (const auto &[name, index] : slots.byName)
+		used.push_back(index);
+
+	for (uint32_t index : used)
+		FreeSlot(slots, index);
+}
+
+template<>
+std::shared_ptr<Texture> ResourceManager::LoadAsync<Texture>(const std::string &name, const std::string &path)
+{
+	// The cache already decodes on the job system and uploads in ProcessUploads
+	auto texture = m_textureCache.LoadAsync(path);
+	Add<Texture>(name, texture);
+	return texture;
+}
+
+template<>
+std::shared_ptr<Model> ResourceManager::LoadAsync<Model>(const std::string &name, const std::string &path)
+{
+	AddModelLoad(name, path);
+	return Load<Model>(name);
+}
+
+LoadGraph::NodeId ResourceManager::AddTextureLoad(const std::string &name, const std::string &path, Texture::TextureType type,
+	bool generateMipMaps, Texture::Residency residency)
+{
+	bool reserved = false;
+	auto texture = m_textureCache.Reserve(path, type, generateMipMaps, residency, reserved);
+	Add<Texture>(name, texture);
+
+	if (reserved)
+		return AddTextureNode(texture, path, generateMipMaps, residency);
+
+	// Requested before, dependents have to wait for the node that fills it
+	auto it = m_loading.find(texture.get());
+	if (it != m_loading.end())
+		return it->second;
+
+	// Loaded already, or still streaming through the cache's own queue
+	return m_loadGraph.Add(name, nullptr, [this, texture]()
+		{
+			if (!texture->IsLoaded())
+				m_textureCache.WaitFor(*texture);
+		});
+}
+
+LoadGraph::NodeId ResourceManager::AddTextureNode(const std::shared_ptr<Texture> &texture, const std::string &path, bool generateMipMaps,
+	Texture::Residency residency)
+{
+	auto image = std::make_shared<Texture::Image>();
+	auto decoded = std::make_shared<bool>(false);
+	Texture::TextureType type = texture->GetType();
+
+	auto node = m_loadGraph.Add(std::filesystem::path(path).filename().string(),
+		[image, decoded, path, type, generateMipMaps]()
+		{
+			*decoded = TextureCache::Decode(path, type, generateMipMaps, *image);
+			return *decoded;
+		},
+		[this, texture, image, decoded, path, generateMipMaps, residency]()
+		{
+			// A failed decode is uploaded as a neutral pixel, like the cache's own async loads
+			m_textureCache.Fill(texture, path, generateMipMaps, residency, std::move(*image), *decoded);
+			m_loading.erase(texture.get());
+		});
+	m_loading[texture.get()] = node;
+	return node;
+}
+
+LoadGraph::NodeId ResourceManager::AddMaterialLibraryLoad(const std::string &path)
+{
+	std::string name = std::filesystem::path(path).filename().string();
+	if (m_materialLibraries.count(FileSystem::Normalize(path)) > 0)
+		return m_loadGraph.Add(name, nullptr, nullptr);
+
+	auto materials = std::make_shared<std::vector<MaterialData>>();
+	return m_loadGraph.Add(name,
+		[materials, path]()
+		{
+			auto loader = LoaderFactory<MaterialLoader>::CreateLoader(std::filesystem::path(path).extension().string());
+			return loader && loader->Load(path, *materials);
+		},
+		[this, materials, path]()
+		{
+			// Textures the cache does not have yet become children, so the library finishes once they are uploaded
+			std::string key = FileSystem::Normalize(path);
+			if (m_materialLibraries.count(key) == 0)
+				m_materialLibraries[key] = CreateMaterials(*materials);
+		});
+}
+
+LoadGraph::NodeId ResourceManager::AddModelLoad(const std::string &name, const std::string &path,
+	const std::vector<LoadGraph::NodeId> &materialLibraries)
+{
+	auto model = std::make_shared<Model>();
+	model->SetName(name);
+	Add<Model>(name, model);
+
+	auto data = std::make_shared<ModelData>();
+	auto loaded = std::make_shared<bool>(false);
+
+	auto node = m_loadGraph.Add(name,
+		[data, loaded, path]()
+		{
+			*loaded = Model::LoadData(path, *data);
+			return *loaded;
+		},
+		[this, model, data, loaded]()
+		{
+			// LoadData reports failures, the placeholder then stays empty
+			if (*loaded)
+				model->Build(*data);
+			m_loading.erase(model.get());
+		},
+		materialLibraries);
+	m_loading[model.get()] = node;
+	return node;
+}
+
+std::vector<std::shared_ptr<Material>> ResourceManager::LoadMaterialLibrary(const std::string &path)
+{
+	std::string key = FileSystem::Normalize(path);
+	auto it = m_materialLibraries.find(key);
+	if (it != m_materialLibraries.end())
+		return it->second;
+
+	std::vector<MaterialData> materials;
+	auto loader = LoaderFactory<MaterialLoader>::CreateLoader(std::filesystem::path(path).extension().string());
+	if (!loader || !loader->Load(path, materials))
+	{
+		// Not cached, a fixed file is picked up by the next model using it
+		std::cerr << "Failed to load materials from: " << path << std::endl;
+		return {};
+	}
+
+	return m_materialLibraries[key] = CreateMaterials(materials);
+}
+
+std::vector<std::shared_ptr<Material>> ResourceManager::CreateMaterials(const std::vector<MaterialData> &materials)
+{
+	std::vector<std::shared_ptr<Material>> created;
+	for (const auto &data : materials)
+	{
+		auto material = std::make_shared<Material>();
+		material->SetName(data.name);
+		material->SetProperties(data.properties);
+
+		for (const auto &[type, texturePath] : data.textures)
+		{
+			bool reserved = false;
+			auto texture = m_textureCache.Reserve(texturePath, type, true, Texture::Residency::GpuOnly, reserved);
+			if (reserved)
+				AddTextureNode(texture, texturePath, true, Texture::Residency::GpuOnly);
+			material->AddTexture(type, texture);
+		}
+		created.push_back(material);
+	}
+	return created;
+}
+
+void ResourceManager::ProcessLoads()
+{
+	PROFILE_SCOPE("ResourceManager::ProcessLoads");
+	if (m_loadGraph.Process())
+		LogLoadReport();
+	m_textureCache.ProcessUploads();
+	GpuMemory::Update();
+}
+
+void ResourceManager::WaitForLoads()
+{
+	PROFILE_SCOPE("ResourceManager::WaitForLoads");
+	m_loadGraph.Wait();
+	LogLoadReport();
+	m_textureCache.WaitForUploads();
+}
+
+void ResourceManager::WaitFor(const Resource &resource)
+{
+	PROFILE_SCOPE("ResourceManager::WaitFor");
+	auto it = m_loading.find(&resource);
+	if (it != m_loading.end())
+		m_loadGraph.WaitForGl(it->second);
+}
+
+void ResourceManager::WaitFor(const Texture &texture)
+{
+	if (m_loading.count(&texture) > 0)
+		WaitFor(static_cast<const Resource &>(texture));
+	else
+		m_textureCache.WaitFor(texture);
+}
+
+void ResourceManager::LogLoadReport()
+{
+	if (!m_loadGraph.HasReport())
+		return;
+	Log::Info(m_loadGraph.TakeReport().ToString());
+
+	ShaderCache::Stats shaderStats = m_shaderCache.GetStats();
+	std::ostringstream shaders;
+	shaders << std::fixed << std::setprecision(1) << "Shader cache: " << m_shaderCache.GetSize() << " programs compiled in "
+		<< shaderStats.compileMs << " ms, " << shaderStats.hits << " hits saved " << shaderStats.savedMs << " ms, "
+		<< ProgramBinaryCache::GetStats().loaded << " loaded from program binaries";
+	Log::Info(shaders.str());
+}
@@ -1,4 +1,7 @@
 #include "Engine/Scene.h"
+#include "Engine/Profiler.h"
+#include "Engine/GpuProfiler.h"
+#include "Engine/RenderStats.h"
 
 Scene::Scene()
 	: m_root(std::make_shared<SceneNode>())
@@ -28,6 +31,7 @@ std::shared_ptr<SceneNode> Scene::GetRoot() const {
 }
 
 void Scene::Draw(Renderer *renderer) {
+	PROFILE_SCOPE("Scene::Draw");
 	if (!m_camera) return;
 
 	// Update states
@@ -36,10 +40,14 @@ void Scene::Draw(Renderer *renderer) {
 	UpdateFogUBO(renderer);
 
 	// Draw scene
+	{
+		GPU_PROFILE_SCOPE("Opaque");
+		m_root->Draw();
+	}
 
-	m_root->Draw();
 	if (m_skybox)
 	{
+		GPU_PROFILE_SCOPE("Skybox");
 		bool perspective = m_camera->GetProjectionType() == Camera::ProjectionType::Perspective;
 		if (!perspective)
 		{
@@ -64,6 +72,7 @@ void Scene::UpdateMatricesUBO(Renderer *renderer) const
 	glBindBuffer(GL_UNIFORM_BUFFER, renderer->GetMatricesUBO());
 	glBufferSubData(GL_UNIFORM_BUFFER, 0, 2 * sizeof(glm::mat4), reinterpret_cast<float *>(&(*ubo)));
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	RenderStats::AddBufferUpload(sizeof(ubo));
 }
 
 void Scene::UpdateFogUBO(Renderer *renderer) const
@@ -71,6 +80,7 @@ void Scene::UpdateFogUBO(Renderer *renderer) const
 	glBindBuffer(GL_UNIFORM_BUFFER, renderer->GetFogUBO());
 	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Fog), &m_fog);
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	RenderStats::AddBufferUpload(sizeof(Fog));
 }
 
 std::shared_ptr<SceneNode> Scene::AddObject(std::shared_ptr<GraphicsObject> obj, SceneNode *parent) {
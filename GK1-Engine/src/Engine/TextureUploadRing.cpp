@@ -0,0 +1,261 @@
+#include "Engine/TextureUploadRing.h"
+#include "Engine/Profiler.h"
+#include "Engine/RenderStats.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+GLuint TextureUploadRing::s_buffer = 0;
+size_t TextureUploadRing::s_head = 0;
+std::deque<TextureUploadRing::Range> TextureUploadRing::s_inFlight;
+
+namespace
+{
+	constexpr size_t kAlignment = 256;
+	constexpr GLuint64 kWaitTimeout = 1000000000; // 1 s
+}
+
+void TextureUploadRing::TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+	GLenum format, GLenum type, const void *pixels, size_t size)
+{
+	PROFILE_SCOPE("TextureUploadRing::TexImage2D");
+	RenderStats::AddTextureUpload(size);
+
+	size_t offset;
+	if (!Stage(pixels, size, offset))
+	{
+		glTexImage2D(target, level, internalFormat, width, height, 0, format, type, pixels);
+		return;
+	}
+
+	glTexImage2D(target, level, internalFormat, width, height, 0, format, type, reinterpret_cast<const void *>(static_cast<uintptr_t>(offset)));
+	Submit(offset, size);
+}
+
+void TextureUploadRing::CompressedTexImage2D(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height,
+	const void *data, size_t size)
+{
+	PROFILE_SCOPE("TextureUploadRing::CompressedTexImage2D");
+	RenderStats::AddTextureUpload(size);
+
+	size_t offset;
+	if (!Stage(data, size, offset))
+	{
+		glCompressedTexImage2D(target, level, internalFormat, width, height, 0, static_cast<GLsizei>(size), data);
+		return;
+	}
+
+	glCompressedTexImage2D(target, level, internalFormat, width, height, 0, static_cast<GLsizei>(size),
+		reinterpret_cast<const void *>(static_cast<uintptr_t>(offset)));
+	Submit(offset, size);
+}
+
+void TextureUploadRing::TexSubImage2D(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format, GLenum type,
+	const void *pixels, size_t size)
+{
+	PROFILE_SCOPE("TextureUploadRing::TexSubImage2D");
+	RenderStats::AddTextureUpload(size);
+
+	size_t offset;
+	if (!Stage(pixels, size, offset))
+	{
+		glTexSubImage2D(target, level, 0, 0, width, height, format, type, pixels);
+		return;
+	}
+
+	glTexSubImage2D(target, level, 0, 0, width, height, format, type, reinterpret_cast<const void *>(static_cast<uintptr_t>(offset)));
+	Submit(offset, size);
+}
+
+void TextureUploadRing::CompressedTexSubImage2D(GLenum target, GLint level, GLsizei width, GLsizei height, GLenum format,
+	const void *data, size_t size)
+{
+	PROFILE_SCOPE("TextureUploadRing::CompressedTexSubImage2D");
+	RenderStats::AddTextureUpload(size);
+
+	size_t offset;
+	if (!Stage(data, size, offset))
+	{
+		glCompressedTexSubImage2D(target, level, 0, 0, width, height, format, static_cast<GLsizei>(size), data);
+		return;
+	}
+
+	glCompressedTexSubImage2D(target, level, 0, 0, width, height, format, static_cast<GLsizei>(size),
+		reinterpret_cast<const void *>(static_cast<uintptr_t>(offset)));
+	Submit(offset, size);
+}
+
+void TextureUploadRing::TexSubImage3D(GLenum target, GLint level, GLsizei width, GLsizei height, GLsizei depth, GLenum format,
+	GLenum type, const void *pixels, size_t size)
+{
+	PROFILE_SCOPE("TextureUploadRing::TexSubImage3D");
+	RenderStats::AddTextureUpload(size);
+
+	size_t offset;
+	if (!Stage(pixels, size, offset))
+	{
+		glTexSubImage3D(target, level, 0, 0, 0, width, height, depth, format, type, pixels);
+		return;
+	}
+
+	glTexSubImage3D(target, level, 0, 0, 0, width, height, depth, format, type, reinterpret_cast<const void *>(static_cast<uintptr_t>(offset)));
+	Submit(offset, size);
+}
+
+void TextureUploadRing::CompressedTexSubImage3D(GLenum target, GLint level, GLsizei width, GLsizei height, GLsizei depth,
+	GLenum format, const void *data, size_t size)
+{
+	PROFILE_SCOPE("TextureUploadRing::CompressedTexSubImage3D");
+	RenderStats::AddTextureUpload(size);
+
+	size_t offset;
+	if (!Stage(data, size, offset))
+	{
+		glCompressedTexSubImage3D(target, level, 0, 0, 0, width, height, depth, format, static_cast<GLsizei>(size), data);
+		return;
+	}
+
+	glCompressedTexSubImage3D(target, level, 0, 0, 0, width, height, depth, format, static_cast<GLsizei>(size),
+		reinterpret_cast<const void *>(static_cast<uintptr_t>(offset)));
+	Submit(offset, size);
+}
+
+bool TextureUploadRing::Stage(const void *data, size_t size, size_t &offset)
+{
+	if (!data || size == 0 || size > kRingSize)
+	{
+		return false;
+	}
+
+	if (s_buffer == 0)
+	{
+		glGenBuffers(1, &s_buffer);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_buffer);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, kRingSize, nullptr, GL_STREAM_DRAW);
+	}
+	else
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_buffer);
+	}
+
+	if (!Allocate(size, offset))
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return false;
+	}
+
+	// The fences already guarantee the range is idle, so the driver does not have to synchronize
+	void *destination = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, offset, size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (!destination)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return false;
+	}
+
+	std::memcpy(destination, data, size);
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	return true;
+}
+
+void TextureUploadRing::Submit(size_t offset, size_t size)
+{
+	s_inFlight.push_back({ offset, size, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+	s_head = offset + size;
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void TextureUploadRing::Shutdown()
+{
+	for (const auto &range : s_inFlight)
+	{
+		glDeleteSync(range.fence);
+	}
+	s_inFlight.clear();
+
+	if (s_buffer != 0)
+	{
+		glDeleteBuffers(1, &s_buffer);
+		s_buffer = 0;
+	}
+	s_head = 0;
+}
+
+bool TextureUploadRing::Allocate(size_t size, size_t &offset)
+{
+	RetireSignaled();
+
+	while (true)
+	{
+		if (s_inFlight.empty())
+		{
+			s_head = 0;
+		}
+
+		// Continue after the last upload, wrap to the start when the end is too short
+		offset = (s_head + kAlignment - 1) & ~(kAlignment - 1);
+		if (offset + size > kRingSize)
+		{
+			offset = 0;
+		}
+
+		bool overlaps = false;
+		for (const auto &range : s_inFlight)
+		{
+			if (offset < range.offset + range.size && range.offset < offset + size)
+			{
+				overlaps = true;
+				break;
+			}
+		}
+
+		if (!overlaps)
+		{
+			return true;
+		}
+
+		// Ranges are freed in upload order
+		if (!WaitOldest())
+		{
+			return false;
+		}
+	}
+}
+
+void TextureUploadRing::RetireSignaled()
+{
+	while (!s_inFlight.empty())
+	{
+		GLenum status = glClientWaitSync(s_inFlight.front().fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		{
+			break;
+		}
+		glDeleteSync(s_inFlight.front().fence);
+		s_inFlight.pop_front();
+	}
+}
+
+bool TextureUploadRing::WaitOldest()
+{
+	PROFILE_SCOPE("TextureUploadRing::Wait");
+
+	// A range whose fence did not signal stays in flight, the GPU may still read it
+	GLenum status = glClientWaitSync(s_inFlight.front().fence, GL_SYNC_FLUSH_COMMANDS_BIT, kWaitTimeout);
+	if (status == GL_TIMEOUT_EXPIRED)
+	{
+		std::cerr << "Texture upload ring: timed out waiting for the GPU, uploading from client memory" << std::endl;
+		return false;
+	}
+	if (status == GL_WAIT_FAILED)
+	{
+		std::cerr << "Texture upload ring: waiting for the GPU failed, uploading from client memory" << std::endl;
+		return false;
+	}
+
+	glDeleteSync(s_inFlight.front().fence);
+	s_inFlight.pop_front();
+	return true;
+}
@@ -10,7 +10,7 @@
 class MyApp : public App
 {
 public:
-	MyApp(std::string title, int width, int height);
+	MyApp(std::string title, int width, int height, HeadlessMode headless = HeadlessMode::None);
 	~MyApp();
 	void OnStart() override;
 	void OnLoad(ResourceManager *rm) override;
@@ -6,7 +6,13 @@
 #include <Engine/Objects/Light/PointLight.h>
 #include <Engine/Objects/Terrain.h>
 #include <Engine/ResourceManager.h>
+#include <Engine/Resource/GpuMemory.h>
+#include <Engine/Resource/ProgramBinaryCache.h>
+#include <Engine/FileSystem.h>
 #include <Engine/Log.h>
+#include <Engine/Profiler.h>
+#include <Engine/GpuProfiler.h>
+#include <Engine/RenderStats.h>
 #include <Engine/Renderer.h>
 #include <Engine/Input.h>
 #include <Engine/Scene.h>
@@ -30,8 +36,13 @@ static BulletDebugDrawer *debugDrawer = nullptr;
 static glm::vec3 cubeRot = glm::vec3(0.0f);
 static glm::vec3 cubePos = glm::vec3(0.0f);
 
-MyApp::MyApp(std::string title, int width, int height)
-	: App(title, width, height)
+// Written by GK1-Cooker --cubemap-array from the day faces followed by the night faces
+static constexpr char kSkyboxArrayPath[] = "assets/textures/skybox/skybox.ktx2";
+// Written by GK1-Cooker --pack, files it does not contain are still read from assets/
+static constexpr char kAssetPackPath[] = "assets.gk1pak";
+
+MyApp::MyApp(std::string title, int width, int height, HeadlessMode headless)
+	: App(title, width, height, headless)
 	, m_physicsManager(std::make_unique<PhysicsManager>())
 {
 	// Physics simulation break when unlocking the framerate
@@ -49,8 +60,15 @@ void MyApp::OnStart()
 	scene = std::make_unique<Scene>();
 
 	auto skybox = std::make_shared<Skybox>();
-	skybox->SetCubemap(ResourceManager::Get().Load<Texture>("SkyboxDay"));
-	skybox->SetNightCubemap(ResourceManager::Get().Load<Texture>("SkyboxNight"));
+	if (auto skyboxArray = ResourceManager::Get().TryLoad<Texture>("SkyboxArray"))
+	{
+		skybox->SetCubemap(skyboxArray);
+	}
+	else
+	{
+		skybox->SetCubemap(ResourceManager::Get().Load<Texture>("SkyboxDay"));
+		skybox->SetNightCubemap(ResourceManager::Get().Load<Texture>("SkyboxNight"));
+	}
 	scene->SetSkybox(skybox);
 
 	cameras[0] = std::make_shared<Camera>();
@@ -74,11 +92,11 @@ void MyApp::OnStart()
 	m_cameraController = std::make_unique<RacingCameraController>(cameras[0]);
 	m_flyCameraController = std::make_unique<FlyCameraController>(cameras[3]);
 
-	model1 = Model::LoadFromFile("assets/models/ball/ball.obj");
+	model1 = ResourceManager::Get().Load<Model>("Ball");
 	model1->SetPosition(glm::vec3(5.0f, 0.0f, 0.0f));
 	auto node1 = scene->AddObject(model1);
 
-	model2 = Model::LoadFromFile("assets/models/eye/eyeball.obj");
+	model2 = ResourceManager::Get().Load<Model>("Eye");
 	model2->SetPosition(glm::vec3(0.0f, 5.0f, 0.0f));
 	model2->SetScale(glm::vec3(0.5f));
 	auto node2 = scene->AddObject(model2, node1.get());
@@ -92,8 +110,12 @@ void MyApp::OnStart()
 	light2->LookAt(glm::vec3(0.0f, -1.0f, 0.0f));
 	scene->AddLight(light2, node1.get());
 
+	// The collision mesh below reads the height map on the CPU
+	auto heightmap = ResourceManager::Get().Load<Texture>("TerrainHeight");
+	ResourceManager::Get().WaitFor(*heightmap);
+
 	terrain = std::make_shared<Terrain>();
-	terrain->SetHeightmap(ResourceManager::Get().Load<Texture>("TerrainHeight"));
+	terrain->SetHeightmap(heightmap);
 	auto shader = terrain->GetMaterial()->GetShader();
 	auto mat = ResourceManager::Get().Load<Material>("TerrainMaterial");
 	mat->SetShader(shader);
@@ -133,8 +155,10 @@ void MyApp::OnStart()
 	btRigidBody *terrainBody = new btRigidBody(rigidBodyCI);
 	m_physicsManager->AddRigidBody(terrainBody);
 
-	auto wheelModel = Model::LoadFromFile("assets/models/pickup_car/Wheel.obj");
-	auto vehicleModel = Model::LoadFromFile("assets/models/pickup_car/Hilux.obj");
+	// The wheel radius is taken from the model's bounds, the body can stream in later
+	auto wheelModel = ResourceManager::Get().Load<Model>("Wheel");
+	ResourceManager::Get().WaitFor(*wheelModel);
+	auto vehicleModel = ResourceManager::Get().Load<Model>("Hilux");
 	vehicle = std::make_shared<Vehicle>(
 		m_physicsManager->GetDynamicsWorld(),
 		vehicleModel, wheelModel,
@@ -150,7 +174,7 @@ void MyApp::OnStart()
 	vehicleLight2->SetPosition(glm::vec3(0.75f, -0.1f, 2.2f));
 	scene->AddLight(vehicleLight2, vehicleNode.get());
 
-	auto cube = Model::LoadFromFile("assets/models/cottage/cottage_obj.obj");
+	auto cube = ResourceManager::Get().Load<Model>("Cottage");
 	cube->SetPosition(glm::vec3(50.0f, -4.0f, -30.0f));
 	scene->AddObject(cube);
 
@@ -160,30 +184,58 @@ void MyApp::OnStart()
 
 void MyApp::OnLoad(ResourceManager *rm)
 {
-	rm->Add<Texture>("SkyboxDay", Texture::CreateCubemap(
-		{
-			"assets/textures/skybox/miramar/front.tga",
-			"assets/textures/skybox/miramar/back.tga",
-			"assets/textures/skybox/miramar/top.tga",
-			"assets/textures/skybox/miramar/bottom.tga",
-			"assets/textures/skybox/miramar/right.tga",
-			"assets/textures/skybox/miramar/left.tga",
-		}
-		));
-
-	rm->Add<Texture>("SkyboxNight", Texture::CreateCubemap(
-		{
-			"assets/textures/skybox/night/right.png",
-			"assets/textures/skybox/night/left.png",
-			"assets/textures/skybox/night/top.png",
-			"assets/textures/skybox/night/bottom.png",
-			"assets/textures/skybox/night/back.png",
-			"assets/textures/skybox/night/front.png",
-		}
-		));
+	if (FileSystem::Exists(kAssetPackPath) && FileSystem::Mount(kAssetPackPath))
+		Log::Info(std::string("Mounted ") + kAssetPackPath + " with " + std::to_string(FileSystem::GetMountedEntryCount()) + " files");
+
+	// Every file is parsed and decoded in parallel on the job system, models are built once their materials and
+	// textures are in. OnStart only waits for what it reads on the CPU and the rest streams in after the first frame.
+	auto ballMaterials = rm->AddMaterialLibraryLoad("assets/models/ball/ball.mtl");
+	auto eyeMaterials = rm->AddMaterialLibraryLoad("assets/models/eye/eyeball.mtl");
+	auto hiluxMaterials = rm->AddMaterialLibraryLoad("assets/models/pickup_car/Hilux.mtl");
+	auto cottageMaterials = rm->AddMaterialLibraryLoad("assets/models/cottage/cottage_obj.mtl");
+
+	rm->AddModelLoad("Ball", "assets/models/ball/ball.obj", { ballMaterials });
+	rm->AddModelLoad("Eye", "assets/models/eye/eyeball.obj", { eyeMaterials });
+	// OnStart builds the vehicle from the wheel right away, its textures stream in with the rest
+	rm->AddModelLoad("Wheel", "assets/models/pickup_car/Wheel.obj");
+	rm->AddModelLoad("Hilux", "assets/models/pickup_car/Hilux.obj", { hiluxMaterials });
+	rm->AddModelLoad("Cottage", "assets/models/cottage/cottage_obj.obj", { cottageMaterials });
+
+	auto &textures = rm->GetTextureCache();
+	const std::vector<std::string> dayFaces = {
+		"assets/textures/skybox/miramar/front.tga",
+		"assets/textures/skybox/miramar/back.tga",
+		"assets/textures/skybox/miramar/top.tga",
+		"assets/textures/skybox/miramar/bottom.tga",
+		"assets/textures/skybox/miramar/right.tga",
+		"assets/textures/skybox/miramar/left.tga",
+	};
+	const std::vector<std::string> nightFaces = {
+		"assets/textures/skybox/night/right.png",
+		"assets/textures/skybox/night/left.png",
+		"assets/textures/skybox/night/top.png",
+		"assets/textures/skybox/night/bottom.png",
+		"assets/textures/skybox/night/back.png",
+		"assets/textures/skybox/night/front.png",
+	};
+
+	// Both skies cooked into one cubemap array by GK1-Cooker take a single texture binding
+	std::vector<std::string> skyFaces = dayFaces;
+	skyFaces.insert(skyFaces.end(), nightFaces.begin(), nightFaces.end());
+	if (TextureCache::IsCookedUpToDate(kSkyboxArrayPath, skyFaces))
+	{
+		rm->Add<Texture>("SkyboxArray", textures.LoadAsync(kSkyboxArrayPath, Texture::TextureType::CubemapArray, false));
+	}
+	else
+	{
+		rm->Add<Texture>("SkyboxDay", textures.LoadCubemapAsync(dayFaces));
+		rm->Add<Texture>("SkyboxNight", textures.LoadCubemapAsync(nightFaces));
+	}
 
-	rm->Add<Texture>("TerrainHeight", Texture::LoadFromFile("assets/textures/terrain/terrain_height.png", Texture::TextureType::Height, false));
-	rm->Add<Texture>("TerrainDiffuse", Texture::LoadFromFile("assets/textures/terrain/terrain_diffuse.png"));
+	// The collision mesh samples the heights on the CPU
+	rm->AddTextureLoad("TerrainHeight", "assets/textures/terrain/terrain_height.png", Texture::TextureType::Height, false,
+		Texture::Residency::KeepCpuCopy);
+	rm->AddTextureLoad("TerrainDiffuse", "assets/textures/terrain/terrain_diffuse.png");
 
 	auto mat = rm->Create<Material>("TerrainMaterial");
 	mat->SetProperties({ glm::vec3(0.7f), glm::vec3(1.0f), glm::vec3(0.1f), 8 });
@@ -202,6 +254,15 @@ void MyApp::OnUpdate(float deltaTime)
 	if (Input::IsKeyPressed(GLFW_KEY_F2))
 		SetWireframe(!GetWireframe());
 
+	if (Input::IsKeyPressed(GLFW_KEY_F3))
+	{
+		std::string tracePath = "logs/trace_" + std::to_string(static_cast<long long>(glfwGetTime() * 1000.0)) + ".json";
+		if (Profiler::WriteChromeTrace(tracePath))
+			Log::Info("Profiler trace written to " + tracePath);
+		else
+			Log::Error("Failed to write profiler trace to " + tracePath);
+	}
+
 	if (Input::IsKeyPressed(GLFW_KEY_TAB))
 	{
 		m_EnterGame = !m_EnterGame;
@@ -487,10 +548,81 @@ void MyApp::OnImGuiRender()
 				vehicle->GetController()->Flip();
 		}
 
+		if (ImGui::CollapsingHeader("Performance"))
+		{
+			static float frameTimes[240] = {};
+			static int frameTimeOffset = 0;
+			frameTimes[frameTimeOffset] = io.DeltaTime * 1000.0f;
+			frameTimeOffset = (frameTimeOffset + 1) % IM_ARRAYSIZE(frameTimes);
+
+			float maxFrameTime = 0.0f;
+			for (float frameTime : frameTimes)
+				maxFrameTime = std::max(maxFrameTime, frameTime);
+
+			char overlay[32];
+			snprintf(overlay, sizeof(overlay), "max %.2f ms", maxFrameTime);
+
+			ImGui::SeparatorText("Frame");
+			ImGui::Text("%.2f ms (%.0f FPS)", io.DeltaTime * 1000.0f, io.Framerate);
+			ImGui::PlotLines("##FrameTimes", frameTimes, IM_ARRAYSIZE(frameTimes), frameTimeOffset,
+				overlay, 0.0f, std::max(maxFrameTime, 33.3f), ImVec2(0.0f, 60.0f));
+
+			ImGui::SeparatorText("GPU");
+			for (const auto &result : GpuProfiler::GetResults())
+				ImGui::Text("%s: %.3f ms", result.name, result.milliseconds);
+
+			const auto &stats = RenderStats::Last();
+			ImGui::SeparatorText("Renderer");
+			ImGui::Text("Draw Calls: %u", stats.drawCalls);
+			ImGui::Text("Triangles: %llu", static_cast<unsigned long long>(stats.triangles));
+			ImGui::Text("Terrain Patches: %llu", static_cast<unsigned long long>(stats.patches));
+			ImGui::Text("Program Changes: %u", stats.programChanges);
+			ImGui::Text("Texture Binds: %u", stats.textureBinds);
+			ImGui::Text("Uniform Uploads: %u", stats.uniformUploads);
+			ImGui::Text("Buffer Uploads: %.2f KB", stats.bufferBytes / 1024.0);
+			ImGui::Text("Texture Uploads: %.2f KB", stats.textureBytes / 1024.0);
+
+			const auto &textureCache = ResourceManager::Get().GetTextureCache();
+			const auto &cacheStats = textureCache.GetStats();
+			ImGui::SeparatorText("Texture Cache");
+			ImGui::Text("Textures: %zu", textureCache.GetSize());
+			ImGui::Text("Hits: %llu / Misses: %llu", static_cast<unsigned long long>(cacheStats.hits),
+				static_cast<unsigned long long>(cacheStats.misses));
+			ImGui::Text("Saved: %.2f MB", cacheStats.bytesSaved / (1024.0 * 1024.0));
+			ImGui::Text("CPU Copies: %.2f / %.2f MB", Texture::GetCpuBytes() / (1024.0 * 1024.0), Texture::GetCpuBudget() / (1024.0 * 1024.0));
+
+			const auto &shaderCache = ResourceManager::Get().GetShaderCache();
+			const auto shaderStats = shaderCache.GetStats();
+			ImGui::SeparatorText("Shader Cache");
+			ImGui::Text("Programs: %zu", shaderCache.GetSize());
+			ImGui::Text("Hits: %llu / Misses: %llu", static_cast<unsigned long long>(shaderStats.hits),
+				static_cast<unsigned long long>(shaderStats.misses));
+			ImGui::Text("Compile: %.1f ms / Saved: %.1f ms", shaderStats.compileMs, shaderStats.savedMs);
+			const auto binaryStats = ProgramBinaryCache::GetStats();
+			ImGui::Text("Binaries: %llu loaded / %llu stored / %llu rejected", static_cast<unsigned long long>(binaryStats.loaded),
+				static_cast<unsigned long long>(binaryStats.stored), static_cast<unsigned long long>(binaryStats.rejected));
+
+			const auto gpuStats = GpuMemory::GetStats();
+			ImGui::SeparatorText("GPU Memory");
+			ImGui::Text("Resident: %.2f / %.2f MB in %zu objects", gpuStats.bytes / (1024.0 * 1024.0),
+				GpuMemory::GetBudget() / (1024.0 * 1024.0), gpuStats.objects);
+			ImGui::Text("Evictions: %llu / Restores: %llu", static_cast<unsigned long long>(gpuStats.evictions),
+				static_cast<unsigned long long>(gpuStats.restores));
+			int budgetMb = static_cast<int>(GpuMemory::GetBudget() / (1024 * 1024));
+			if (ImGui::SliderInt("Budget (MB)", &budgetMb, 64, 4096))
+				GpuMemory::SetBudget(static_cast<size_t>(budgetMb) * 1024 * 1024);
+
+			const auto fileStats = FileSystem::GetStats();
+			ImGui::SeparatorText("Files");
+			ImGui::Text("Pack Reads: %llu / Disk Reads: %llu", static_cast<unsigned long long>(fileStats.packReads),
+				static_cast<unsigned long long>(fileStats.diskReads));
+		}
+
 		if (ImGui::CollapsingHeader("Controls"))
 		{
 			ImGui::BulletText("F1 - Toggle Control Panel");
 			ImGui::BulletText("F2 - Toggle Wireframe");
+			ImGui::BulletText("F3 - Dump Profiler Trace");
 			ImGui::BulletText("TAB - Enter Game");
 			ImGui::BulletText("1-4 - Switch Camera");
 			ImGui::BulletText("WASD - Control Vehicle");
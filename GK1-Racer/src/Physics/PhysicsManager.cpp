@@ -1,4 +1,5 @@
 #include "Physics/PhysicsManager.h"
+#include <Engine/Profiler.h>
 
 PhysicsManager::PhysicsManager() {
 	m_collisionConfiguration = new btDefaultCollisionConfiguration();
@@ -20,6 +21,7 @@ PhysicsManager::~PhysicsManager() {
 }
 
 void PhysicsManager::Update(float deltaTime) {
+	PROFILE_SCOPE("PhysicsManager::Update");
 	m_dynamicsWorld->stepSimulation(deltaTime, 10);
 }
 